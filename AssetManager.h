@@ -12,7 +12,8 @@
  * RESPONSIBILITIES:
  * - Load all texture files (backgrounds, metro platforms, character heads)
  * - Load and control background music
- * - Provide texture access via getter methods
+ * - Preload sound effects and play them from a fixed voice pool (SoundBank)
+ * - Provide sprite (texture + UV rectangle) access via getter methods
  * - Handle music playback state (play/pause/mute)
  * 
  * MANAGED ASSETS:
@@ -20,68 +21,297 @@
  * - Metro platform texture (metro_side_view.PNG)
  * - 4 player head textures (p1.PNG, p2.PNG, p3.PNG, P4.PNG)
  * - Background music (song file)
+ * - Sound effects (sfx/jump.wav, coin.wav, ability.wav, crash.wav;
+ *   synthesized when missing)
+ * 
+ * ASYNC LOADING:
+ * - beginLoading() starts worker threads that load images in parallel
+ *   (background first), one that opens the music stream and one that
+ *   decodes every sound effect
+ * - Images come from TextureCache blobs, already scaled down to the size
+ *   they are drawn at (textureLimit()); a missing or stale blob is rebuilt
+ *   from the source image on the worker
+ * - pumpUploads() runs on the GL thread every frame and uploads whatever
+ *   finished decoding, through a pixel unpack buffer
+ * - waitForTexture() / finishLoading() block (while still uploading) when a
+ *   screen cannot be drawn without a texture
+ * - Music starts playing as soon as it is open, unless already muted
+ * 
+ * ATLAS:
+ * - Once everything is loaded, buildAtlas() packs all images (and the
+ *   font, added by Game) into shared TextureAtlas pages
+ * - Callers draw through SpriteRegion getters, which point at the
+ *   standalone texture before that and at the atlas page after
  * 
  * USED BY:
  * - Game class (initializes assets, provides textures to renderers)
  * - UIRenderer (gets textures for rendering)
  * 
  * DEPENDENCIES:
- * - Texture class for image loading
- * - SFML Audio for music playback
+ * - Texture class for upload, TextureCache for decoded mip chains
+ * - SFML Audio for music playback, SoundBank for effects
  */
 
 #include <SFML/Audio.hpp>
+#include <atomic>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameConfig.h"
 #include "Texture.h"
+#include "TextureCache.h"
+#include "TextureAtlas.h"
+#include "SoundBank.h"
+
+enum AssetTexture {
+    ASSET_BACKGROUND,
+    ASSET_METRO,
+    ASSET_PLAYER_HEAD_0,   // heads 0..3 follow in order
+    ASSET_TEXTURE_COUNT = ASSET_PLAYER_HEAD_0 + 4
+};
 
 class AssetManager {
 private:
-    Texture bgTexture;
-    Texture metroTexture;
-    Texture playerHeads[4];
+    static const int MAX_DECODE_THREADS = 4;
+    
+    Texture textures[ASSET_TEXTURE_COUNT];
+    bool textureDone[ASSET_TEXTURE_COUNT];   // uploaded, or failed to decode
+    int texturesDone;
+    
+    // What draws use: the standalone texture until buildAtlas() moves it
+    // into a shared page. The mapped blobs are kept until then as its source.
+    SpriteRegion sprites[ASSET_TEXTURE_COUNT];
+    TextureBlob atlasSources[ASSET_TEXTURE_COUNT];
+    TextureAtlas atlas;
+    
     sf::Music music;
     bool musicMuted;
+    bool musicStarted;
+    SoundBank sounds;
     
-public:
-    AssetManager() : musicMuted(false) {}
+    // Decode workers take jobs in order; finished images wait for the GL thread
+    struct DecodeResult {
+        int index;
+        bool ok;
+        bool fromCache;
+        TextureBlob blob;
+    };
+    std::vector<std::thread> workers;
+    std::atomic<int> nextJob;
+    std::mutex resultMutex;
+    std::condition_variable resultReady;
+    std::vector<DecodeResult> results;
+    
+    std::thread musicLoader;
+    std::atomic<bool> musicOpened;
+    bool musicOk;                 // written by musicLoader before musicOpened
+    
+    unsigned int uploadPbo;
+    
+    static const char* texturePath(int index) {
+        static const char* paths[ASSET_TEXTURE_COUNT] = {
+            "imgs/metro_background.jpg",
+            "imgs/metro_side_view.PNG",
+            "imgs/players/p1.PNG",
+            "imgs/players/p2.PNG",
+            "imgs/players/p3.PNG",
+            "imgs/players/P4.PNG"
+        };
+        return paths[index];
+    }
+    
+    // Largest size each image is drawn at in the 1200x800 virtual frame,
+    // which is all the detail that can reach the screen. Nothing is drawn
+    // minified by much (atlas pages carry no mips anyway), so no mip chains.
+    static TextureLimit textureLimit(int index) {
+        static const TextureLimit limits[ASSET_TEXTURE_COUNT] = {
+            TextureLimit(SCREEN_WIDTH, SCREEN_HEIGHT, false),   // full-screen background
+            TextureLimit(350, 100, false),                      // one metro platform
+            TextureLimit(40, 40, false),                        // heads: 40 px on character select,
+            TextureLimit(40, 40, false),                        // 25 px in game
+            TextureLimit(40, 40, false),
+            TextureLimit(40, 40, false)
+        };
+        return limits[index];
+    }
     
-    bool loadAssets() {
-        if (!bgTexture.load("imgs/metro_background.jpg")) {
-            std::cerr << "Warning: failed to load imgs/metro_background.jpg\n";
+    void decodeWorker() {
+        for (;;) {
+            int index = nextJob.fetch_add(1);
+            if (index >= ASSET_TEXTURE_COUNT) return;
+            
+            DecodeResult result;
+            result.index = index;
+            result.ok = TextureCache::acquire(texturePath(index), textureLimit(index),
+                                              result.blob, result.fromCache);
+            
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(std::move(result));
+            resultReady.notify_all();
         }
-        if (!metroTexture.load("imgs/metro_side_view.PNG")) {
-            std::cerr << "Warning: failed to load imgs/metro_side_view.PNG\n";
+    }
+    
+    void musicWorker() {
+        musicOk = music.openFromFile("song");
+        musicOpened.store(true);
+    }
+    
+    void startMusicIfOpen() {
+        if (musicStarted || !musicOpened.load()) return;
+        if (musicLoader.joinable()) musicLoader.join();
+        musicStarted = true;
+        
+        if (!musicOk) {
+            std::cerr << "Warning: Failed to load song\n";
+            return;
         }
-        if (!playerHeads[0].load("imgs/players/p1.PNG")) {
-            std::cerr << "Warning: failed to load imgs/players/p1.PNG\n";
+        music.setLoop(true);
+        if (!musicMuted) music.play();
+        std::cout << "Background music started! Press M to mute/unmute" << std::endl;
+    }
+    
+    void joinWorkers() {
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
         }
-        if (!playerHeads[1].load("imgs/players/p2.PNG")) {
-            std::cerr << "Warning: failed to load imgs/players/p2.PNG\n";
+        workers.clear();
+        if (musicLoader.joinable()) musicLoader.join();
+    }
+    
+public:
+    AssetManager() : texturesDone(0), musicMuted(false), musicStarted(false),
+        nextJob(0), musicOpened(false), musicOk(false), uploadPbo(0) {
+        for (int i = 0; i < ASSET_TEXTURE_COUNT; i++) {
+            textureDone[i] = false;
+            sprites[i] = SpriteRegion::whole(&textures[i]);
         }
-        if (!playerHeads[2].load("imgs/players/p3.PNG")) {
-            std::cerr << "Warning: failed to load imgs/players/p3.PNG\n";
+    }
+    
+    ~AssetManager() {
+        joinWorkers();
+    }
+    
+    // Needs a current GL context (for the upload buffer)
+    void beginLoading() {
+        glGenBuffers(1, &uploadPbo);
+        
+        unsigned int hw = std::thread::hardware_concurrency();
+        int threads = hw == 0 ? 2 : (int)hw;
+        if (threads > MAX_DECODE_THREADS) threads = MAX_DECODE_THREADS;
+        for (int i = 0; i < threads; i++) {
+            workers.push_back(std::thread(&AssetManager::decodeWorker, this));
         }
-        if (!playerHeads[3].load("imgs/players/P4.PNG")) {
-            std::cerr << "Warning: failed to load imgs/players/P4.PNG\n";
+        musicLoader = std::thread(&AssetManager::musicWorker, this);
+        sounds.beginLoading();
+    }
+    
+    // GL thread: upload everything that finished decoding since the last call.
+    // Returns how many textures were uploaded (they change GL bindings).
+    int pumpUploads() {
+        startMusicIfOpen();
+        sounds.pump();
+        if (texturesDone == ASSET_TEXTURE_COUNT) return 0;
+        
+        std::vector<DecodeResult> ready;
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            ready.swap(results);
         }
         
-        if (!music.openFromFile("song")) {
-            std::cerr << "Warning: Failed to load song\n";
-        } else {
-            music.setLoop(true);
-            music.play();
-            std::cout << "Background music started! Press M to mute/unmute" << std::endl;
+        for (size_t i = 0; i < ready.size(); i++) {
+            DecodeResult& result = ready[i];
+            if (result.ok) {
+                textures[result.index].upload(texturePath(result.index), result.blob.getMips(), uploadPbo);
+                if (!result.fromCache) {
+                    std::cout << "Texture cache rebuilt: " << TextureCache::blobPath(texturePath(result.index)) << std::endl;
+                }
+                atlasSources[result.index] = std::move(result.blob);
+            } else {
+                std::cout << "Failed to load texture: " << texturePath(result.index) << std::endl;
+                std::cerr << "Warning: failed to load " << texturePath(result.index) << "\n";
+            }
+            textureDone[result.index] = true;
+            texturesDone++;
         }
         
-        return true;
+        if (texturesDone == ASSET_TEXTURE_COUNT) {
+            for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+            workers.clear();
+            glDeleteBuffers(1, &uploadPbo);
+            uploadPbo = 0;
+        }
+        return (int)ready.size();
     }
     
-    Texture* getBackgroundTexture() { return &bgTexture; }
-    Texture* getMetroTexture() { return &metroTexture; }
-    Texture* getPlayerHead(int index) { return &playerHeads[index]; }
+    // Block until one texture is usable, uploading others as they arrive
+    void waitForTexture(int index) {
+        for (;;) {
+            pumpUploads();
+            if (textureDone[index]) return;
+            std::unique_lock<std::mutex> lock(resultMutex);
+            resultReady.wait(lock, [this] { return !results.empty(); });
+        }
+    }
+    
+    // Block until every asset (including the music stream) is loaded
+    void finishLoading() {
+        for (int i = 0; i < ASSET_TEXTURE_COUNT; i++) {
+            waitForTexture(i);
+        }
+        if (!musicStarted && musicLoader.joinable()) {
+            musicLoader.join();
+            startMusicIfOpen();
+        }
+        sounds.finishLoading();
+    }
+    
+    bool isLoading() const {
+        return texturesDone < ASSET_TEXTURE_COUNT || !musicStarted || !sounds.isReady();
+    }
+    
+    // Pack every loaded image, plus whatever the caller added to getAtlas()
+    // first, into shared pages. Call after finishLoading(). Sprites that made
+    // it into a page switch over and their standalone textures are freed.
+    bool buildAtlas() {
+        int handles[ASSET_TEXTURE_COUNT];
+        for (int i = 0; i < ASSET_TEXTURE_COUNT; i++) {
+            handles[i] = -1;
+            const MipChain& mips = atlasSources[i].getMips();
+            if (mips.levels > 0) {
+                handles[i] = atlas.add(mips.data[0], mips.width[0], mips.height[0]);
+            }
+        }
+        
+        bool built = atlas.build();
+        for (int i = 0; i < ASSET_TEXTURE_COUNT; i++) {
+            SpriteRegion region = atlas.region(handles[i]);
+            if (built && region.isValid()) {
+                sprites[i] = region;
+                textures[i].release();
+            }
+            atlasSources[i] = TextureBlob();
+        }
+        if (built) {
+            std::cout << "Texture atlas: " << atlas.getPageCount() << " page(s)" << std::endl;
+        }
+        return built;
+    }
+    
+    TextureAtlas& getAtlas() { return atlas; }
+    
+    const SpriteRegion& getBackgroundSprite() const { return sprites[ASSET_BACKGROUND]; }
+    const SpriteRegion& getMetroSprite() const { return sprites[ASSET_METRO]; }
+    const SpriteRegion& getPlayerHeadSprite(int index) const { return sprites[ASSET_PLAYER_HEAD_0 + index]; }
     
     void toggleMusic() {
         musicMuted = !musicMuted;
+        if (!musicStarted) {
+            // Still opening; startMusicIfOpen() honours the new state
+            std::cout << (musicMuted ? "Music muted" : "Music unmuted") << std::endl;
+            return;
+        }
         if (musicMuted) {
             music.pause();
             std::cout << "Music muted" << std::endl;
@@ -92,6 +322,9 @@ public:
     }
     
     bool isMusicMuted() const { return musicMuted; }
+    
+    // Fire-and-forget effect; cheap enough to call from every tick
+    void playSound(SoundEffect effect) { sounds.play(effect); }
 };
 
 #endif
@@ -0,0 +1,143 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+/**
+ * BenchReport
+ * ===========
+ *
+ * PURPOSE:
+ * Machine-readable results for the bench_* executables, so runs can be
+ * diffed between releases. Human-readable progress goes to stderr; the
+ * report goes to stdout or to --out file.
+ *
+ * FORMAT (one JSON object per run):
+ *   {
+ *     "benchmark": "bench_world",
+ *     "schema": 1,
+ *     "timestamp": 1760000000,
+ *     "compiler": "...",
+ *     "results": [
+ *       {"name": "...", "params": {"key": number, ...}, "metrics": {"key": number, ...}}
+ *     ]
+ *   }
+ * Metric names carry their unit (ticks_per_sec, load_us_p50...). Numbers
+ * that are not finite are written as null.
+ *
+ * USED BY:
+ * - bench_render.cpp, bench_world.cpp, bench_io.cpp
+ *
+ * DEPENDENCIES:
+ * - None (standard library only)
+ */
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BenchReport {
+public:
+    static const int SCHEMA = 1;
+
+    struct Result {
+        std::string name;
+        std::vector<std::pair<std::string, double> > params;
+        std::vector<std::pair<std::string, double> > metrics;
+
+        Result& param(const std::string& key, double value) {
+            params.push_back(std::make_pair(key, value));
+            return *this;
+        }
+
+        Result& metric(const std::string& key, double value) {
+            metrics.push_back(std::make_pair(key, value));
+            return *this;
+        }
+    };
+
+private:
+    std::string benchmark;
+    std::vector<Result> results;
+
+    static std::string quoted(const std::string& text) {
+        std::string out = "\"";
+        for (size_t i = 0; i < text.size(); i++) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if ((unsigned char)c < 0x20) {
+                out += ' ';
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+    static std::string number(double value) {
+        if (!std::isfinite(value)) return "null";
+        std::ostringstream out;
+        out.precision(10);
+        out << value;
+        return out.str();
+    }
+
+    static void writeObject(std::ostream& out, const std::vector<std::pair<std::string, double> >& fields) {
+        out << "{";
+        for (size_t i = 0; i < fields.size(); i++) {
+            out << (i ? ", " : "") << quoted(fields[i].first) << ": " << number(fields[i].second);
+        }
+        out << "}";
+    }
+
+public:
+    explicit BenchReport(const std::string& name) : benchmark(name) {}
+
+    // The returned reference is valid until the next add()
+    Result& add(const std::string& name) {
+        results.push_back(Result());
+        results.back().name = name;
+        return results.back();
+    }
+
+    void write(std::ostream& out) const {
+        long long timestamp = (long long)std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        out << "{\n";
+        out << "  \"benchmark\": " << quoted(benchmark) << ",\n";
+        out << "  \"schema\": " << SCHEMA << ",\n";
+        out << "  \"timestamp\": " << timestamp << ",\n";
+#ifdef __VERSION__
+        out << "  \"compiler\": " << quoted(__VERSION__) << ",\n";
+#endif
+        out << "  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& result = results[i];
+            out << (i ? ",\n" : "\n") << "    {\"name\": " << quoted(result.name) << ", \"params\": ";
+            writeObject(out, result.params);
+            out << ", \"metrics\": ";
+            writeObject(out, result.metrics);
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    // To 'path', or stdout when it is empty. Returns false if the file can't be written.
+    bool save(const std::string& path) const {
+        if (path.empty()) {
+            write(std::cout);
+            return true;
+        }
+        std::ofstream file(path.c_str(), std::ios::trunc);
+        if (!file.is_open()) return false;
+        write(file);
+        return (bool)file;
+    }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef BOT_POLICY_H
+#define BOT_POLICY_H
+
+/**
+ * BotPolicy
+ * =========
+ * 
+ * PURPOSE:
+ * Generates TickInput for a Simulation without a human at the keyboard,
+ * for headless load tests and difficulty tuning.
+ * 
+ * POLICIES:
+ * - RANDOM: jump / ability with fixed per-tick probabilities
+ * - SCRIPTED: jump every N ticks, ability whenever it is ready
+ * - LOOKAHEAD: jump when an obstacle or a gap is coming up in front of
+ *   the player, use the ability whenever it is ready
+ * 
+ * Each policy owns its own xorshift state so runs don't depend on rand().
+ */
+
+#include <cstdint>
+#include <string>
+#include "Simulation.h"
+
+enum class BotKind {
+    RANDOM,
+    SCRIPTED,
+    LOOKAHEAD
+};
+
+inline bool parseBotKind(const std::string& name, BotKind& out) {
+    if (name == "random") { out = BotKind::RANDOM; return true; }
+    if (name == "scripted") { out = BotKind::SCRIPTED; return true; }
+    if (name == "lookahead") { out = BotKind::LOOKAHEAD; return true; }
+    return false;
+}
+
+class BotPolicy {
+private:
+    BotKind kind;
+    uint32_t rngState;
+    int jumpInterval;
+    
+    uint32_t nextRandom() {
+        // xorshift32
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return rngState;
+    }
+    
+    bool chance(uint32_t perThousand) {
+        return nextRandom() % 1000 < perThousand;
+    }
+    
+    // Is something worth jumping for within 'distance' px in front of the player?
+    static bool dangerAhead(const Simulation& sim, float distance) {
+        const GameWorld& world = sim.getWorld();
+        const Player& player = sim.getPlayer();
+        float front = player.x + player.width;
+        
+        const ObstacleRing& obstacles = world.getObstacles();
+        for (int n = 0; n < obstacles.size(); n++) {
+            int i = obstacles.slot(n);
+            // Flying obstacles sit above a standing player; only ground ones need a jump
+            if (obstacles.flags[i] & ENTITY_FLYING) continue;
+            if (obstacles.x[i] + obstacles.w[i] > player.x && obstacles.x[i] < front + distance) return true;
+        }
+        
+        // A gap: the point just ahead of the player's center isn't over any metro
+        float probe = player.x + player.width / 2 + distance * 0.5f;
+        for (const auto& metro : world.getMetros()) {
+            if (probe > metro.x && probe < metro.x + metro.width) return false;
+        }
+        return true;
+    }
+    
+public:
+    BotPolicy(BotKind k = BotKind::LOOKAHEAD, uint32_t seed = 1, int interval = 45)
+        : kind(k), rngState(seed ? seed : 1), jumpInterval(interval) {}
+    
+    TickInput decide(const Simulation& sim) {
+        TickInput input;
+        const Player& player = sim.getPlayer();
+        bool abilityReady = player.abilityCooldown <= 0;
+        
+        switch (kind) {
+            case BotKind::RANDOM:
+                input.jump = chance(30);
+                input.ability = abilityReady && chance(5);
+                break;
+                
+            case BotKind::SCRIPTED:
+                input.jump = jumpInterval > 0 && sim.getTicks() % jumpInterval == 0;
+                input.ability = abilityReady;
+                break;
+                
+            case BotKind::LOOKAHEAD: {
+                float speed = sim.getWorld().getLastScrollStep();
+                input.jump = !player.isJumping && dangerAhead(sim, 12.0f * speed + 20.0f);
+                input.ability = abilityReady;
+                break;
+            }
+        }
+        return input;
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+/**
+ * FramePacer
+ * ==========
+ *
+ * PURPOSE:
+ * Decides when a PLAYING frame starts and measures how long a key press
+ * takes to reach the screen, so the pacing modes in GameOptions can be
+ * compared on real hardware.
+ *
+ * MODES (see GameOptions.h):
+ * - vsync / off: only set the swap interval; frames start immediately
+ * - cap: swap interval 0; each frame starts on a fixed deadline grid,
+ *   reached with a precise sleep (sleep_for, then a short yield spin)
+ * - low-latency: swap interval 1 plus glFinish() after the swap, so the
+ *   CPU knows when the last vblank was. The next frame starts one refresh
+ *   period after that, minus the predicted frame work and a margin, so
+ *   input is sampled and simulated just before it is needed. Frame work is
+ *   measured up to the swap call; GPU time has to fit in LATE_MARGIN.
+ *
+ * LATENCY:
+ * recordLatency() takes press -> present times (key callback timestamp to
+ * the return of glfwSwapBuffers, after glFinish in low-latency mode). It is
+ * a lower bound on what the display shows; printSummary() at exit reports
+ * avg / p50 / p99 / max for the mode in use.
+ *
+ * USED BY:
+ * - Game class (run loop and presentFrame)
+ *
+ * DEPENDENCIES:
+ * - GLFW for the clock and swap interval, GLAD for glFinish
+ * - GameOptions for the mode
+ */
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "GameOptions.h"
+
+class FramePacer {
+private:
+    static constexpr double SPIN_MARGIN = 0.0015;     // spin this close to a deadline
+    static constexpr double LATE_MARGIN = 0.002;      // low-latency safety margin
+    static const size_t MAX_LATENCY_SAMPLES = 100000;
+
+    PacingMode mode;
+    double period;
+
+    // Frame timing
+    double frameStart;
+    double nextDeadline;      // cap mode
+    double lastPresent;       // low-latency mode: ~ the last vblank
+    double predictedWork;     // decaying max of frameStart -> swap call
+    bool inFrame;             // waitForFrame() ran since the last swap
+    bool havePresent;
+
+    std::vector<float> latencyMs;
+
+    static void preciseSleepUntil(double target) {
+        double remaining = target - glfwGetTime();
+        if (remaining > SPIN_MARGIN) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(remaining - SPIN_MARGIN));
+        }
+        while (glfwGetTime() < target) {
+            std::this_thread::yield();
+        }
+    }
+
+public:
+    FramePacer() : mode(PacingMode::VSYNC), period(1.0 / 60.0), frameStart(0),
+        nextDeadline(0), lastPresent(0), predictedWork(0), inFrame(false), havePresent(false) {}
+
+    // After the GL context is current. 'refreshRate' from the video mode.
+    void init(const GameOptions& options, int refreshRate) {
+        mode = options.pacing;
+        double refreshPeriod = 1.0 / (refreshRate > 0 ? refreshRate : 60);
+        period = (mode == PacingMode::CAP && options.fpsCap > 0) ? 1.0 / options.fpsCap : refreshPeriod;
+
+        bool vsync = mode == PacingMode::VSYNC || mode == PacingMode::LOW_LATENCY;
+        glfwSwapInterval(vsync ? 1 : 0);
+        std::cout << "Frame pacing: " << pacingModeName(mode)
+                  << " (" << period * 1000.0 << " ms period)" << std::endl;
+    }
+
+    // Block until this PLAYING frame should sample input
+    void waitForFrame() {
+        double now = glfwGetTime();
+        if (mode == PacingMode::CAP) {
+            // Fell more than a frame behind: restart the grid instead of bursting
+            if (nextDeadline < now - period) nextDeadline = now;
+            preciseSleepUntil(nextDeadline);
+            nextDeadline += period;
+        } else if (mode == PacingMode::LOW_LATENCY && havePresent) {
+            double work = std::min(predictedWork + LATE_MARGIN, period);
+            preciseSleepUntil(lastPresent + period - work);
+        }
+        frameStart = glfwGetTime();
+        inFrame = true;
+    }
+
+    // Right before glfwSwapBuffers; a blocking swap is not frame work
+    void beforeSwap() {
+        if (!inFrame) return;
+        double work = glfwGetTime() - frameStart;
+        if (work > predictedWork) predictedWork = work;
+        else predictedWork += (work - predictedWork) * 0.02;
+        inFrame = false;
+    }
+
+    // Right after glfwSwapBuffers. Returns the present time.
+    double framePresented() {
+        if (mode == PacingMode::LOW_LATENCY) glFinish();
+        double now = glfwGetTime();
+        lastPresent = now;
+        havePresent = true;
+        return now;
+    }
+
+    void recordLatency(double seconds) {
+        if (latencyMs.size() < MAX_LATENCY_SAMPLES) latencyMs.push_back((float)(seconds * 1000.0));
+    }
+
+    void printSummary() const {
+        if (latencyMs.empty()) return;
+        std::vector<float> sorted(latencyMs);
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0;
+        for (size_t i = 0; i < sorted.size(); i++) sum += sorted[i];
+        std::cout << "Input-to-present latency (" << pacingModeName(mode) << ", "
+                  << sorted.size() << " presses): avg " << sum / sorted.size()
+                  << " ms, p50 " << sorted[(sorted.size() - 1) * 50 / 100]
+                  << " ms, p99 " << sorted[(sorted.size() - 1) * 99 / 100]
+                  << " ms, max " << sorted.back() << " ms" << std::endl;
+    }
+
+    PacingMode getMode() const { return mode; }
+    double getPeriod() const { return period; }
+};
+
+#endif
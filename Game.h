@@ -17,7 +17,7 @@
  * 3. GameWorld - Updates game objects and physics
  * 4. UIRenderer - Renders all UI elements
  * 5. ScoreManager - Persists high scores
- * 6. Player - Player state and abilities
+ * 6. Simulation - GameWorld + Player stepping, shared with headless_sim
  * 7. Renderer2D - Low-level OpenGL rendering
  * 
  * GAME STATES:
@@ -27,18 +27,93 @@
  * - GAME_OVER: Show scores, allow restart
  * 
  * MAIN LOOP FLOW:
- * 1. handleInput() - Process keyboard via InputManager
- * 2. update(deltaTime) - Update game state via GameWorld and Player
- * 3. render(currentTime) - Draw everything via UIRenderer
+ * 1. handleInput() - Process keyboard via InputManager (menus, global keys)
+ * 2. update(deltaTime) - Run fixed 60 Hz simulation ticks via GameWorld and Player
+ * 3. render(currentTime) - Draw everything via UIRenderer, interpolated
+ *    between the last two ticks, into the VirtualScreen, then upscale it
+ * 
+ * FIXED TIMESTEP:
+ * - Frame time feeds an accumulator; the simulation always steps SIM_DT
+ * - Per-tick constants (scroll speed, gravity) are tuned for 60 ticks/s,
+ *   so game speed no longer depends on the display refresh rate
+ * - At most MAX_TICKS_PER_FRAME ticks per frame, so a long stall slows the
+ *   game down instead of spiralling
+ * - Rendering blends the player's previous and current Y and offsets the
+ *   world by the unapplied part of the last scroll step
+ * - Key events carry callback timestamps; each tick takes the jump/ability
+ *   presses that happened before its end, so two taps in one frame land on
+ *   separate ticks and a tap shorter than a frame still counts
+ * 
+ * IDLE MODE (START_SCREEN, CHARACTER_SELECT, GAME_OVER):
+ * - The loop blocks in glfwWaitEventsTimeout() instead of spinning
+ * - The static part of the screen is cached in an off-screen framebuffer
+ * - A frame is only drawn when the screen contents change, the window needs
+ *   a refresh, or the pulsing restart prompt is due (30 FPS)
+ * 
+ * ASSET STREAMING:
+ * - Images decode on worker threads; finished ones are uploaded at the top
+ *   of every frame (AssetManager::pumpUploads)
+ * - The start screen appears once the background is ready; leaving it
+ *   waits for whatever is still loading
+ * - Sound effects decode in the background too; each tick's SimEvent bits
+ *   (jump, ability, coin, crash) fire them from the update loop
+ * 
+ * FRAME PACING (GameOptions --pacing, see FramePacer):
+ * - The swap interval is always set explicitly (vsync unless asked not to)
+ * - While PLAYING, each frame first waits in FramePacer::waitForFrame(),
+ *   then polls events, samples input, simulates, renders and swaps, so
+ *   input is as fresh as the mode allows
+ * - Every presented frame records press -> present latency for the presses
+ *   it consumed; the summary is printed on exit
+ * 
+ * VIRTUAL RESOLUTION (see VirtualScreen):
+ * - The window is fullscreen at the monitor's native mode, but every frame
+ *   is drawn at SCREEN_WIDTH x SCREEN_HEIGHT off-screen and upscaled in one
+ *   quad, letterboxed, so fill rate does not grow with the display
+ * - --dynamic-res lowers the internal scale while the scene pass misses
+ *   its GPU budget and raises it again once there is headroom
+ * - The idle screen cache is virtual-sized too
+ * 
+ * GPU WORLD (GameOptions --gpu-world, see WorldBuffer):
+ * - Metros, obstacles and coins stay in a GPU buffer in world space; each
+ *   frame uploads only what spawned, was recycled or was collected, and
+ *   one scroll uniform (including the interpolation lag) moves them all
+ * - Without the option they go through the sprite batch every frame
+ * 
+ * THREADED MODE (GameOptions --threaded, see SimThread):
+ * - Each run is stepped on a simulation thread at fixed deadlines; the GL
+ *   thread forwards key events to it and renders the newest WorldSnapshot,
+ *   interpolated from the snapshot's tick time
+ * - Both loops share sampleTickInput(), so recording and replay behave the
+ *   same; update() plays the thread's sound events and calls endGame()
+ *   after joining it
+ * - renderPlaying() draws a SceneView, which points at either the live
+ *   Simulation or a snapshot
+ * 
+ * PROFILING (build with -DMETRO_PROFILE):
+ * - Each frame phase (input, update, render, swap) is timed by FrameProfiler
+ * - The render pass is wrapped in a GPU timer query
+ * - Renderer2D's RenderStats and the drawn scene's entity count become
+ *   the frame's counters; add -DMETRO_COUNT_ALLOCS for heap allocations
+ * - F3 toggles the overlay; counter averages are printed on exit and
+ *   METRO_PROFILE_OUT=<prefix> dumps CSV/trace
  * 
  * INITIALIZATION SEQUENCE:
- * 1. Init GLFW and create window (1280x720)
- * 2. Load OpenGL via GLAD
+ * 1. Init GLFW and create a fullscreen window at the monitor's mode
+ * 2. Load OpenGL via GLAD, set the swap interval for the pacing mode,
+ *    enable the shader program cache (ProgramCache)
  * 3. Create InputManager with window pointer
  * 4. Create UIRenderer with Renderer2D
- * 5. Load all assets via AssetManager
+ * 5. Start async asset loading; wait only for the background texture
  * 6. Initialize GameWorld with platforms
  * 7. Position player at ground level
+ * 8. Warm up every draw pipeline off-screen before the first frame
+ * 
+ * RECORD / REPLAY (GameOptions --record / --replay, see InputRecording):
+ * - Every run gets its own world seed (fixed with --seed)
+ * - Recording stores the seed, character and each tick's TickInput
+ * - Replay skips the menus and feeds the recorded inputs to the ticks in
+ *   real time, then reports whether the run ended exactly as recorded
  * 
  * STATE TRANSITIONS:
  * START_SCREEN -> CHARACTER_SELECT: Any key press
@@ -48,7 +123,7 @@
  * 
  * COORDINATE SYSTEM:
  * - Origin (0,0) at top-left
- * - Screen size: 1280x720 pixels
+ * - Virtual screen: SCREEN_WIDTH x SCREEN_HEIGHT (1200x800), any window size
  * - Y increases downward
  * 
  * DEPENDENCIES:
@@ -60,14 +135,21 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
-#include <ctime>
-#include <cstdlib>
 #include "InputManager.h"
+#include "GameOptions.h"
+#include "FramePacer.h"
 #include "AssetManager.h"
-#include "GameWorld.h"
+#include "Simulation.h"
+#include "SimThread.h"
 #include "UIRenderer.h"
+#include "RenderTarget.h"
+#include "VirtualScreen.h"
+#include "WorldBuffer.h"
 #include "GameData.h"
+#include "InputRecording.h"
+#include "Random.h"
 #include "Player.h"
+#include "Profiler.h"
 
 enum class GameState {
     START_SCREEN,
@@ -76,29 +158,101 @@ enum class GameState {
     GAME_OVER
 };
 
+// What a non-PLAYING screen shows; any change makes the cached frame stale
+struct IdleScreenKey {
+    GameState state;
+    int selectedChar;
+    int coins;
+    int bestScore;
+    
+    bool operator==(const IdleScreenKey& o) const {
+        return state == o.state && selectedChar == o.selectedChar &&
+               coins == o.coins && bestScore == o.bestScore;
+    }
+    bool operator!=(const IdleScreenKey& o) const { return !(*this == o); }
+};
+
+// What renderPlaying() draws: the live Simulation, or a SimThread snapshot
+struct SceneView {
+    const Player* player;
+    float prevPlayerY;
+    float lastScrollStep;
+    int coinsCollected;
+    const std::vector<Metro>* metros;
+    const ObstacleRing* obstacles;
+    const CoinRing* coins;
+    float alpha;              // between the previous tick and this one
+};
+
 class Game {
 private:
     GLFWwindow* window;
     Renderer2D* renderer;
     
+    GameOptions options;
+    FramePacer pacer;
+    VirtualScreen virtualScreen;
+    WorldBuffer worldBuffer;
     InputManager* inputManager;
     AssetManager assetManager;
-    GameWorld gameWorld;
+    Simulation sim;
+    InputManager simInput;    // --threaded: key events forwarded to the sim thread
+    SimThread simThread;
     UIRenderer* uiRenderer;
     ScoreManager scoreManager;
     
     GameState state;
-    Player player;
+    TickInput pendingInput;   // sampled from InputManager for each tick
     int selectedChar;
     float lastTime;
     
+    // Fixed timestep
+    static const int MAX_TICKS_PER_FRAME = 5;
+    float accumulator;
+    bool simClockReset;
+    
+    // Idle mode
+    static constexpr double IDLE_ANIMATION_INTERVAL = 1.0 / 30.0;
+    static constexpr double IDLE_WAIT_TIMEOUT = 0.5;
+    static constexpr double LOADING_POLL_INTERVAL = 0.01;   // wake up to upload finished assets
+    RenderTarget screenCache;
+    bool screenCacheValid;
+    IdleScreenKey cachedScreen;
+    bool redrawRequested;
+    double lastIdleFrame;
+    
+    bool showDebugOverlay;
+    int drawnEntities;        // metros, obstacles and coins in this frame's scene
+    
+    // --record / --replay
+    InputRecording recording;
+    bool recordingActive;
+    InputRecording replay;
+    bool replaying;
+    
+    static void onWindowRefresh(GLFWwindow* win) {
+        Game* game = static_cast<Game*>(glfwGetWindowUserPointer(win));
+        if (game) game->redrawRequested = true;
+    }
+    
+    static void onKey(GLFWwindow* win, int key, int scancode, int action, int mods) {
+        (void)scancode;
+        (void)mods;
+        Game* game = static_cast<Game*>(glfwGetWindowUserPointer(win));
+        if (game && game->inputManager) game->inputManager->onKey(key, action, glfwGetTime());
+    }
+    
 public:
-    Game() : renderer(nullptr), inputManager(nullptr), uiRenderer(nullptr), 
-             state(GameState::START_SCREEN), selectedChar(0) {
-        srand((unsigned)time(0));
+    explicit Game(const GameOptions& opts = GameOptions())
+           : renderer(nullptr), options(opts), inputManager(nullptr), uiRenderer(nullptr),
+             state(GameState::START_SCREEN), selectedChar(0),
+             accumulator(0), simClockReset(true),
+             screenCacheValid(false), redrawRequested(true), lastIdleFrame(0),
+             showDebugOverlay(true), drawnEntities(0), recordingActive(false), replaying(false) {
     }
     
     ~Game() {
+        simThread.stop();
         delete renderer;
         delete inputManager;
         delete uiRenderer;
@@ -134,43 +288,205 @@ public:
             return false;
         }
         
+#ifdef METRO_PROFILE
+        FrameProfiler::get().initGpu();
+#endif
+        ProgramCache::get().init((GLADloadproc)glfwGetProcAddress);
+        
+        pacer.init(options, mode->refreshRate);
+        virtualScreen.init(options.dynamicResolution, pacer.getPeriod());
+        
         glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Keep destination alpha opaque so cached off-screen frames blit cleanly
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
         
         renderer = new Renderer2D();
-        inputManager = new InputManager(window);
+        inputManager = new InputManager();
+        
+        glfwSetWindowUserPointer(window, this);
+        glfwSetWindowRefreshCallback(window, onWindowRefresh);
+        glfwSetKeyCallback(window, onKey);
         uiRenderer = new UIRenderer(*renderer);
+        if (options.gpuWorld) worldBuffer.init();
         
-        if (!assetManager.loadAssets()) {
-            return false;
-        }
+        // Everything else keeps decoding while the start screen is up
+        assetManager.beginLoading();
+        assetManager.waitForTexture(ASSET_BACKGROUND);
         
-        gameWorld.init();
-        player.y = gameWorld.getGroundY(player);
+        sim.startSegmentWorker();
+        sim.reset(selectedChar, 0);
+        warmUpPipelines();
         lastTime = (float)glfwGetTime();
         
         std::cout << "=== METRO RUNNER ===" << std::endl;
+        
+        if (!options.replayPath.empty()) {
+            if (replay.load(options.replayPath)) {
+                startReplay();
+                return true;
+            }
+            std::cerr << "Warning: cannot read replay " << options.replayPath << std::endl;
+        }
         std::cout << "Press ANY KEY to start!" << std::endl;
         
         return true;
     }
     
+    // Draw once through every pipeline (flat, textured and font quads, the
+    // world buffer, the upscale pass) into the back buffer, which the first
+    // real frame overwrites. Drivers finish compiling state on first use,
+    // so that cost lands here instead of the first visible frames.
+    void warmUpPipelines() {
+        double start = glfwGetTime();
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        
+        virtualScreen.begin(fbWidth, fbHeight);
+        glClearColor(0.53f, 0.81f, 0.98f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer->beginBatch();
+        renderer->drawQuad(0, 0, 1, 1, nullptr, 1, 1, 1, 0);
+        renderer->drawQuad(0, 0, 1, 1, assetManager.getBackgroundSprite(), 1, 1, 1, 0);
+        renderer->drawText("0", 0, 0, 8);
+        renderer->endBatch();
+        if (worldBuffer.isReady()) {
+            worldBuffer.warmUp();
+            renderer->invalidateState();
+        }
+        virtualScreen.present(*renderer, fbWidth, fbHeight);
+        glFinish();
+        
+        ProgramCache::get().printSummary();
+        std::cout << "Pipeline warm-up: " << (glfwGetTime() - start) * 1000.0 << " ms" << std::endl;
+    }
+    
     void run() {
         while (!glfwWindowShouldClose(window)) {
-            float currentTime = (float)glfwGetTime();
+            if (state == GameState::PLAYING) {
+                pacer.waitForFrame();
+                glfwPollEvents();
+            }
+            
+            double now = glfwGetTime();
+            float currentTime = (float)now;
             float deltaTime = currentTime - lastTime;
             lastTime = currentTime;
             
-            handleInput();
-            update(deltaTime);
-            render(currentTime);
+            {
+                PROFILE_PHASE(PHASE_INPUT);
+                if (assetManager.pumpUploads() > 0) {
+                    renderer->invalidateState();
+                }
+                handleInput();
+            }
+            {
+                PROFILE_PHASE(PHASE_UPDATE);
+                update(deltaTime, now);
+            }
             
+            if (state == GameState::PLAYING) {
+                presentFrame(currentTime);
+            } else {
+                if (idleFrameDue(currentTime)) {
+                    presentFrame(currentTime);
+                    lastIdleFrame = currentTime;
+                } else {
+                    // Nothing on screen changed, so no press reached it
+                    double unused;
+                    inputManager->takeConsumedPressTime(unused);
+                }
+                glfwWaitEventsTimeout(idleWaitTimeout(currentTime));
+            }
+        }
+    }
+    
+    void presentFrame(float currentTime) {
+        {
+            PROFILE_PHASE(PHASE_RENDER);
+            PROFILE_GPU_BEGIN();
+            render(currentTime);
+            PROFILE_GPU_END();
+        }
+        recordFrameCounters();
+        {
+            PROFILE_PHASE(PHASE_SWAP);
+            pacer.beforeSwap();
             glfwSwapBuffers(window);
-            glfwPollEvents();
+            double presented = pacer.framePresented();
+            double pressTime;
+            if (takeShownPressTime(pressTime)) {
+                pacer.recordLatency(presented - pressTime);
+            }
+        }
+        PROFILE_FRAME_END();
+    }
+    
+    // Oldest press whose effect the frame just presented shows: consumed
+    // by this thread, or by the sim thread in the snapshot that was drawn
+    bool takeShownPressTime(double& time) {
+        bool found = inputManager->takeConsumedPressTime(time);
+        double simPress;
+        if (simThread.isActive() && simThread.presented(simPress)) {
+            if (!found || simPress < time) time = simPress;
+            found = true;
+        }
+        return found;
+    }
+    
+    // Hand this frame's render and world counters to the profiler and
+    // start counting the next frame
+    void recordFrameCounters() {
+#ifdef METRO_PROFILE
+        const RenderStats& stats = renderer->getStats();
+        FrameProfiler& profiler = FrameProfiler::get();
+        profiler.setCounter(COUNTER_DRAW_CALLS, stats.drawCalls);
+        profiler.setCounter(COUNTER_QUADS, stats.quads);
+        profiler.setCounter(COUNTER_GLYPHS, stats.glyphs);
+        profiler.setCounter(COUNTER_TEXTURE_BINDS, stats.textureBinds);
+        profiler.setCounter(COUNTER_PROGRAM_BINDS, stats.programBinds);
+        profiler.setCounter(COUNTER_UNIFORM_UPLOADS, stats.uniformUploads);
+        profiler.setCounter(COUNTER_ENTITIES, drawnEntities);
+#endif
+        renderer->resetStats();
+        drawnEntities = 0;
+    }
+    
+    void renderDebugOverlay() {
+#ifdef METRO_PROFILE
+        if (!showDebugOverlay) return;
+        renderer->beginBatch();
+        uiRenderer->renderProfilerOverlay(FrameProfiler::get());
+        renderer->endBatch();
+#endif
+    }
+    
+    IdleScreenKey currentScreenKey() const {
+        return IdleScreenKey{state, selectedChar, sim.getWorld().getCoinsCollected(), scoreManager.getBestScore()};
+    }
+    
+    bool idleFrameDue(double currentTime) {
+        IdleScreenKey key = currentScreenKey();
+        if (!screenCacheValid || key != cachedScreen) {
+            screenCacheValid = false;
+            return true;
+        }
+        if (redrawRequested) return true;
+        return state == GameState::GAME_OVER && currentTime - lastIdleFrame >= IDLE_ANIMATION_INTERVAL;
+    }
+    
+    // Sleep until the next animation frame at most; any input wakes us earlier
+    double idleWaitTimeout(double currentTime) const {
+        if (assetManager.isLoading()) return LOADING_POLL_INTERVAL;
+        if (state == GameState::GAME_OVER) {
+            double untilNext = lastIdleFrame + IDLE_ANIMATION_INTERVAL - currentTime;
+            return untilNext > 0.001 ? untilNext : 0.001;
         }
+        return IDLE_WAIT_TIMEOUT;
     }
     
     void handleInput() {
+        inputManager->pumpEvents();
+        
         if (inputManager->isEscapePressed()) {
             glfwSetWindowShouldClose(window, true);
         }
@@ -179,9 +495,18 @@ public:
             assetManager.toggleMusic();
         }
         
+        if (inputManager->isOverlayTogglePressed()) {
+            showDebugOverlay = !showDebugOverlay;
+            redrawRequested = true;
+        }
+        
         switch (state) {
             case GameState::START_SCREEN:
                 if (inputManager->isAnyKeyPressed()) {
+                    // Character select needs the heads; usually long done by now
+                    assetManager.finishLoading();
+                    buildAtlas();
+                    renderer->invalidateState();
                     state = GameState::CHARACTER_SELECT;
                 }
                 break;
@@ -199,13 +524,9 @@ public:
                 break;
                 
             case GameState::PLAYING:
-                if (inputManager->isJumpPressed()) {
-                    player.jump();
-                }
-                if (inputManager->isAbilityPressed()) {
-                    player.activateAbility();
-                }
-                break;
+                // Jump and ability are taken per tick in update(), or by the sim thread
+                if (simThread.isActive()) inputManager->forwardTo(simInput);
+                return;
                 
             case GameState::GAME_OVER:
                 if (inputManager->isSpacePressed()) {
@@ -213,128 +534,360 @@ public:
                 }
                 break;
         }
+        
+        // Menus act on this frame's presses only
+        inputManager->discardUntil(InputManager::ALL);
     }
     
     void startGame() {
-        player = Player();
-        player.headIndex = selectedChar;
-        player.y = gameWorld.getGroundY(player);
+        uint64_t seed;
+        if (replaying) seed = replay.getSeed();
+        else if (options.fixedSeed) seed = options.seed;
+        else seed = Random::entropySeed();
+        sim.reset(selectedChar, seed);
+        
+        if (!replaying && !options.recordPath.empty()) {
+            recording.begin(seed, selectedChar);
+            recordingActive = true;
+        }
+        pendingInput = TickInput();
+        inputManager->discardUntil(InputManager::ALL);
         state = GameState::PLAYING;
-        gameWorld.init();
+        
+        // Time spent on the menu must not turn into a burst of ticks
+        simClockReset = true;
+        
+        if (options.threaded) {
+            simInput.resetFrom(*inputManager);
+            simThread.start(sim, simInput, [this](double tickEnd) { return threadedTick(tickEnd); });
+        }
     }
     
-    void update(float deltaTime) {
-        if (state != GameState::PLAYING) return;
-        
-        updatePlayer(deltaTime);
-        gameWorld.update(deltaTime, player);
-        checkCollisions();
+    // Straight into PLAYING with the recorded character and seed
+    void startReplay() {
+        std::cout << "Replaying " << options.replayPath << ": " << replay.getTickCount()
+                  << " ticks, character " << replay.getCharacter() << std::endl;
+        assetManager.finishLoading();
+        buildAtlas();
+        renderer->invalidateState();
+        selectedChar = replay.getCharacter();
+        replaying = true;
+        startGame();
     }
     
-    void updatePlayer(float deltaTime) {
-        bool standingOnPlatform = gameWorld.isPlayerOnPlatform(player);
-        float groundY = gameWorld.getGroundY(player);
-        
-        if (standingOnPlatform && !player.isJumping) {
-            player.update(groundY, deltaTime);
+    void saveRecording() {
+        recording.finish(sim.getWorld().getCoinsCollected(), sim.isGameOver());
+        recordingActive = false;
+        if (recording.save(options.recordPath)) {
+            std::cout << "Recording saved: " << options.recordPath << " (" << recording.getTickCount()
+                      << " ticks, seed " << recording.getSeed() << ")" << std::endl;
         } else {
-            if (!player.isJumping && player.y >= groundY) {
-                player.isJumping = true;
-                player.velocityY = 1.0f;
+            std::cerr << "Warning: failed to write " << options.recordPath << std::endl;
+        }
+    }
+    
+    // 'now' is the glfwGetTime() this frame's deltaTime ends at
+    void update(float deltaTime, double now) {
+        if (state != GameState::PLAYING) return;
+        
+        if (simThread.isActive()) {
+            // The sim thread keeps its own clock; just pick up what it did
+            const WorldSnapshot& snap = simThread.latest();
+            playTickSounds(simThread.takeEvents());
+            if (snap.ended) {
+                simThread.join();
+                endGame();
             }
-            player.y += player.velocityY;
-            player.velocityY += 0.5f;
+            return;
+        }
+        
+        if (simClockReset) {
+            accumulator = 0;
+            simClockReset = false;
+            return;
+        }
+        
+        accumulator += deltaTime;
+        if (accumulator > MAX_TICKS_PER_FRAME * SIM_DT) {
+            accumulator = MAX_TICKS_PER_FRAME * SIM_DT;
+        }
+        
+        // Tick k of this frame covers wall time up to now - accumulator + SIM_DT;
+        // each one takes the presses that happened before it ends
+        while (accumulator >= SIM_DT && state == GameState::PLAYING) {
+            double tickEnd = now - accumulator + SIM_DT;
+            pendingInput = sampleTickInput(*inputManager, tickEnd);
+            tick(SIM_DT);
+            accumulator -= SIM_DT;
             
-            if (player.y >= groundY && standingOnPlatform) {
-                player.y = groundY;
-                player.velocityY = 0;
-                player.isJumping = false;
-                player.hasDoubleJumped = false;
+            // A recording cut short by quitting ends without a game over
+            if (state == GameState::PLAYING && replayFinished()) {
+                endGame();
             }
         }
+        
+        // Later presses wait for the next frame's ticks; a finished run drops them
+        inputManager->discardUntil(state == GameState::PLAYING ? now - accumulator : InputManager::ALL);
+    }
+    
+    // Input for the tick ending at 'tickEnd': the recorded one when replaying,
+    // else the presses 'input' saw before then. Recorded if recording.
+    TickInput sampleTickInput(InputManager& input, double tickEnd) {
+        TickInput sampled;
+        if (replaying) {
+            sampled = replay.input((uint64_t)sim.getTicks());
+        } else {
+            sampled.jump = input.isJumpPressed(tickEnd);
+            sampled.ability = input.isAbilityPressed(tickEnd);
+        }
+        if (recordingActive) recording.record(sampled);
+        return sampled;
+    }
+    
+    bool replayFinished() const {
+        return replaying && (uint64_t)sim.getTicks() >= replay.getTickCount();
     }
     
-    void checkCollisions() {
-        if (gameWorld.checkObstacleCollision(player) || gameWorld.checkFallThrough(player)) {
+    // Sim thread (--threaded): one step of the run. Returns false when it is
+    // over; update() then joins the thread and calls endGame().
+    bool threadedTick(double tickEnd) {
+        bool alive = sim.tick(sampleTickInput(simInput, tickEnd), SIM_DT);
+        simThread.postEvents(sim.getEvents());
+        return alive && !replayFinished();
+    }
+    
+    // One fixed simulation step
+    void tick(float dt) {
+        bool alive = sim.tick(pendingInput, dt);
+        pendingInput = TickInput();
+        playTickSounds(sim.getEvents());
+        if (!alive) {
             endGame();
         }
     }
     
+    void playTickSounds(uint32_t events) {
+        if (events & SIM_EVENT_JUMP) assetManager.playSound(SFX_JUMP);
+        if (events & SIM_EVENT_ABILITY) assetManager.playSound(SFX_ABILITY);
+        if (events & SIM_EVENT_COIN) assetManager.playSound(SFX_COIN);
+        if (events & SIM_EVENT_CRASH) assetManager.playSound(SFX_CRASH);
+    }
+    
+    // How far rendering is between the previous tick and the current one
+    float interpolationAlpha() const {
+        return accumulator / SIM_DT;
+    }
+    
     void endGame() {
         state = GameState::GAME_OVER;
-        int coins = gameWorld.getCoinsCollected();
-        scoreManager.updateBestScore(coins);
-        scoreManager.addCoins(coins);
+        int coins = sim.getWorld().getCoinsCollected();
+        
+        if (replaying) {
+            // Replays never count as runs
+            replaying = false;
+            std::cout << "\n=== REPLAY FINISHED ===" << std::endl;
+            std::cout << "Coins: " << coins << " (recorded " << replay.getFinalCoins() << "), ticks: "
+                      << sim.getTicks() << " (recorded " << replay.getTickCount() << ")" << std::endl;
+            std::cout << (replay.matches(sim) ? "Replay matches the recording" : "Replay DIVERGED from the recording") << std::endl;
+            return;
+        }
+        if (recordingActive) saveRecording();
+        
+        scoreManager.recordRun(makeRunRecord(coins, sim.getTicks(), sim.getPlayer().headIndex,
+                                             sim.getWorld().getGameSpeed()));
         std::cout << "\n=== GAME OVER ===" << std::endl;
         std::cout << "Coins: " << coins << std::endl;
         std::cout << "Best: " << scoreManager.getBestScore() << std::endl;
     }
     
     void render(float currentTime) {
-        glClearColor(0.53f, 0.81f, 0.98f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        
+        // The cache has its own framebuffer, so it is rebuilt before the frame starts
+        if (state != GameState::PLAYING) updateScreenCache(fbWidth, fbHeight);
         
+        virtualScreen.begin(fbWidth, fbHeight);
+        if (state != GameState::PLAYING) {
+            renderIdleScreen(currentTime);
+        } else {
+            glClearColor(0.53f, 0.81f, 0.98f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            
+            // Everything drawn this frame goes through one sprite batch
+            renderer->beginBatch();
+            if (simThread.isActive()) renderPlaying(snapshotScene(simThread.latest(), glfwGetTime()));
+            else renderPlaying(liveScene());
+            renderer->endBatch();
+        }
+        renderDebugOverlay();
+        virtualScreen.present(*renderer, fbWidth, fbHeight);
+    }
+    
+    // Static contents of the current non-PLAYING screen
+    void renderStaticScreen() {
         switch (state) {
             case GameState::START_SCREEN:
-                uiRenderer->renderStartScreen(assetManager.getBackgroundTexture());
+                uiRenderer->renderStartScreen(assetManager.getBackgroundSprite());
                 break;
                 
             case GameState::CHARACTER_SELECT: {
-                Texture* heads[4] = {
-                    assetManager.getPlayerHead(0),
-                    assetManager.getPlayerHead(1),
-                    assetManager.getPlayerHead(2),
-                    assetManager.getPlayerHead(3)
+                SpriteRegion heads[4] = {
+                    assetManager.getPlayerHeadSprite(0),
+                    assetManager.getPlayerHeadSprite(1),
+                    assetManager.getPlayerHeadSprite(2),
+                    assetManager.getPlayerHeadSprite(3)
                 };
-                uiRenderer->renderCharacterSelect(assetManager.getBackgroundTexture(), heads, selectedChar);
+                uiRenderer->renderCharacterSelect(assetManager.getBackgroundSprite(), heads, selectedChar);
                 break;
             }
                 
-            case GameState::PLAYING:
-                renderPlaying();
+            case GameState::GAME_OVER:
+                uiRenderer->renderGameOverStatic(sim.getWorld().getCoinsCollected(), scoreManager.getBestScore());
                 break;
                 
-            case GameState::GAME_OVER:
-                uiRenderer->renderGameOver(gameWorld.getCoinsCollected(), 
-                                          scoreManager.getBestScore(), currentTime);
+            case GameState::PLAYING:
                 break;
         }
     }
     
-    void renderPlaying() {
+    // Menu and game over screens: rebuild the cached frame (at the virtual
+    // resolution) only when the screen changed
+    void updateScreenCache(int fbWidth, int fbHeight) {
+        if (!screenCacheValid && screenCache.create(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+            screenCache.begin();
+            glClearColor(0.53f, 0.81f, 0.98f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            renderer->beginBatch();
+            renderStaticScreen();
+            renderer->endBatch();
+            screenCache.end(fbWidth, fbHeight);
+            
+            screenCacheValid = true;
+            cachedScreen = currentScreenKey();
+        }
+        redrawRequested = false;
+    }
+    
+    // Draw the cached frame as one quad plus any animated overlay
+    void renderIdleScreen(float currentTime) {
+        glClearColor(0.53f, 0.81f, 0.98f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderer->beginBatch();
+        if (screenCacheValid) {
+            renderer->drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, screenCache.getTexture());
+        } else {
+            // No framebuffer available: draw the screen directly every time
+            renderStaticScreen();
+        }
+        if (state == GameState::GAME_OVER) {
+            uiRenderer->renderGameOverPrompt(currentTime);
+        }
+        renderer->endBatch();
+    }
+    
+    // The simulation as of its last tick (single-threaded loop)
+    SceneView liveScene() const {
+        const GameWorld& gameWorld = sim.getWorld();
+        return SceneView{&sim.getPlayer(), sim.getPrevPlayerY(), gameWorld.getLastScrollStep(),
+                         gameWorld.getCoinsCollected(), &gameWorld.getMetros(),
+                         &gameWorld.getObstacles(), &gameWorld.getCoins(), interpolationAlpha()};
+    }
+    
+    // A sim thread snapshot, interpolated by how far 'now' is past its tick
+    static SceneView snapshotScene(const WorldSnapshot& snap, double now) {
+        float alpha = (float)((now - snap.tickTime) / SIM_DT);
+        alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+        return SceneView{&snap.player, snap.prevPlayerY, snap.lastScrollStep, snap.coinsCollected,
+                         &snap.metros, &snap.obstacles, &snap.coins, alpha};
+    }
+    
+    void renderPlaying(const SceneView& scene) {
+        const Player& player = *scene.player;
+        float alpha = scene.alpha;
+        // Everything scrolls together, so interpolating the world is one offset
+        float scrollLag = scene.lastScrollStep * (1.0f - alpha);
+        drawnEntities = GameWorld::statsFor(*scene.metros, *scene.obstacles, *scene.coins).total();
+        
         renderer->drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, nullptr, 0.7, 0.85, 0.95);
         
+        if (worldBuffer.isReady()) {
+            // The sky must be drawn first; the world buffer has its own program.
+            // Never with --threaded, so the live world is safe to read here.
+            const GameWorld& gameWorld = sim.getWorld();
+            renderer->flush();
+            worldBuffer.sync(gameWorld, assetManager.getMetroSprite());
+            worldBuffer.draw(gameWorld, scrollLag, renderer->getStats());
+            renderer->invalidateState();
+        } else {
+            renderWorldBatched(scene, scrollLag);
+        }
+        
+        // Render player
+        SpriteRegion heads[4] = {
+            assetManager.getPlayerHeadSprite(0),
+            assetManager.getPlayerHeadSprite(1),
+            assetManager.getPlayerHeadSprite(2),
+            assetManager.getPlayerHeadSprite(3)
+        };
+        Player drawnPlayer = player;
+        drawnPlayer.y = scene.prevPlayerY + (player.y - scene.prevPlayerY) * alpha;
+        uiRenderer->renderPlayer(drawnPlayer, heads);
+        
+        // Render HUD
+        uiRenderer->renderHUD(player, scene.coinsCollected, assetManager.isMusicMuted());
+    }
+    
+    // Metros, obstacles and coins through the sprite batch, at this frame's positions
+    void renderWorldBatched(const SceneView& scene, float scrollLag) {
         // Render metros
-        for (const auto& metro : gameWorld.getMetros()) {
-            renderer->drawQuad(metro.x, metro.y, metro.width, 100, assetManager.getMetroTexture());
+        for (const auto& metro : *scene.metros) {
+            renderer->drawQuad(metro.x + scrollLag, metro.y, metro.width, 100, assetManager.getMetroSprite());
         }
         
         // Render obstacles
-        for (const auto& obs : gameWorld.getObstacles()) {
-            float r = obs.isFlying ? 1.0f : 0.8f;
-            float g = obs.isFlying ? 0.5f : 0.2f;
-            renderer->drawQuad(obs.x, obs.y, obs.width, obs.height, nullptr, r, g, 0.2f);
+        const ObstacleRing& obstacles = *scene.obstacles;
+        for (int n = 0; n < obstacles.size(); n++) {
+            int i = obstacles.slot(n);
+            bool flying = obstacles.flags[i] & ENTITY_FLYING;
+            float r = flying ? 1.0f : 0.8f;
+            float g = flying ? 0.5f : 0.2f;
+            renderer->drawQuad(obstacles.x[i] + scrollLag, obstacles.y[i], obstacles.w[i], obstacles.h[i], nullptr, r, g, 0.2f);
         }
         
         // Render coins
-        for (const auto& coin : gameWorld.getCoins()) {
-            renderer->drawQuad(coin.x, coin.y, coin.size, coin.size, nullptr, 1, 0.84, 0);
+        const CoinRing& coins = *scene.coins;
+        for (int n = 0; n < coins.size(); n++) {
+            int i = coins.slot(n);
+            if (coins.flags[i] & ENTITY_COLLECTED) continue;
+            renderer->drawQuad(coins.x[i] + scrollLag, coins.y[i], coins.w[i], coins.h[i], nullptr, 1, 0.84, 0);
+        }
+    }
+    
+    // Pack the loaded images and the font into shared pages, so a PLAYING
+    // frame binds a single texture. Runs once, when loading is complete.
+    void buildAtlas() {
+        if (assetManager.getAtlas().isBuilt()) return;
+        int font = assetManager.getAtlas().add(renderer->getFontPixels(),
+                                               renderer->getFontAtlasWidth(), renderer->getFontAtlasHeight());
+        if (assetManager.buildAtlas()) {
+            renderer->setFontRegion(assetManager.getAtlas().region(font));
+            uiRenderer->invalidateRetained();
         }
-        
-        // Render player
-        Texture* heads[4] = {
-            assetManager.getPlayerHead(0),
-            assetManager.getPlayerHead(1),
-            assetManager.getPlayerHead(2),
-            assetManager.getPlayerHead(3)
-        };
-        uiRenderer->renderPlayer(player, heads);
-        
-        // Render HUD
-        uiRenderer->renderHUD(player, gameWorld.getCoinsCollected(), assetManager.isMusicMuted());
     }
     
     void cleanup() {
+        // The sim thread may still be writing the recording
+        simThread.stop();
+        if (recordingActive) saveRecording();
+        scoreManager.flush();
+        pacer.printSummary();
+        virtualScreen.printSummary();
+        worldBuffer.printSummary();
+#ifdef METRO_PROFILE
+        FrameProfiler::get().printCounterSummary();
+        FrameProfiler::get().dumpIfRequested();
+#endif
         glfwTerminate();
     }
 };
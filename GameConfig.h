@@ -0,0 +1,21 @@
+#ifndef GAME_CONFIG_H
+#define GAME_CONFIG_H
+
+// Shared constants that both the simulation and the renderer need.
+// Kept free of GL/GLFW includes so GameWorld and Player build headless.
+
+const int SCREEN_WIDTH = 1200;
+const int SCREEN_HEIGHT = 800;
+
+// Fixed simulation step. Per-tick constants and the segment generator's
+// spawn cadence are tuned for it.
+const float SIM_DT = 1.0f / 60.0f;
+
+// Console event messages ("Speed increased!", ability activations...).
+// Headless tools turn this off so printing doesn't dominate the run time.
+inline bool& gameLogEnabled() {
+    static bool enabled = true;
+    return enabled;
+}
+
+#endif
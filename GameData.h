@@ -3,8 +3,17 @@
 #include <vector>
 #include <fstream>
 #include <iostream>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include "GameConfig.h"
+#include "RunHistory.h"
 
-// Simple JSON-like data structure for game persistence
+// Simple JSON-like data structure for game persistence. bestScore and
+// totalCoins are derived from the run history; the JSON keeps a copy.
 struct GameData {
     int bestScore;
     int totalCoins;
@@ -13,10 +22,32 @@ struct GameData {
     GameData() : bestScore(0), totalCoins(0), selectedCharacter(0) {}
 };
 
+// Score persistence. Mutators only update memory and mark the data dirty; a
+// background thread coalesces changes made within SAVE_COALESCE_MS of each
+// other into one write (temp file, fsync, rename, so neither a crash nor a
+// power loss leaves a torn or empty file). flush() and the destructor wait until everything is on disk.
+// Finished runs go to a RunHistory log next to the JSON file, whose footer
+// supplies the best score and coin total at startup.
 class ScoreManager {
 private:
+    static const int SAVE_COALESCE_MS = 50;
+    
     std::string filename;
-    GameData data;
+    GameData data;              // owner thread's copy
+    uint32_t runCount;
+    RunHistory history;         // save thread only, after the constructor
+    
+    // Shared with the save thread
+    std::mutex saveMutex;
+    std::condition_variable saveWake;
+    std::condition_variable saveDone;
+    GameData pending;
+    std::vector<RunRecord> pendingRuns;
+    bool dirty;
+    bool writing;
+    bool flushing;              // skip the coalescing delay
+    bool stopping;
+    std::thread saveThread;
     
     void parseJSON(const std::string& content) {
         // Simple JSON parser for our specific format
@@ -44,52 +75,149 @@ private:
         }
     }
     
-    std::string toJSON() {
+    static std::string toJSON(const GameData& d) {
         return "{\n"
-               "  \"bestScore\": " + std::to_string(data.bestScore) + ",\n"
-               "  \"totalCoins\": " + std::to_string(data.totalCoins) + ",\n"
-               "  \"selectedCharacter\": " + std::to_string(data.selectedCharacter) + "\n"
+               "  \"bestScore\": " + std::to_string(d.bestScore) + ",\n"
+               "  \"totalCoins\": " + std::to_string(d.totalCoins) + ",\n"
+               "  \"selectedCharacter\": " + std::to_string(d.selectedCharacter) + "\n"
                "}";
     }
     
-public:
-    ScoreManager(const std::string& file = "gamedata.json") : filename(file) {
-        load();
+    // Runs on the save thread only. The temp file is synced before the
+    // rename; otherwise a power loss can leave an empty file in its place.
+    bool writeFile(const GameData& snapshot) {
+        std::string json = toJSON(snapshot);
+        std::string temp = filename + ".tmp";
+        FILE* outFile = std::fopen(temp.c_str(), "wb");
+        if (!outFile) return false;
+        bool written = std::fwrite(json.data(), 1, json.size(), outFile) == json.size() &&
+                       std::fflush(outFile) == 0 && fsync(fileno(outFile)) == 0;
+        if (std::fclose(outFile) != 0 || !written) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        if (std::rename(temp.c_str(), filename.c_str()) != 0) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+    
+    void saveLoop() {
+        std::unique_lock<std::mutex> lock(saveMutex);
+        for (;;) {
+            saveWake.wait(lock, [this] { return dirty || stopping; });
+            if (!dirty) return;
+            
+            // Let a burst of changes (endGame does two) land first
+            saveWake.wait_for(lock, std::chrono::milliseconds(SAVE_COALESCE_MS),
+                              [this] { return stopping || flushing; });
+            GameData snapshot = pending;
+            std::vector<RunRecord> runs;
+            runs.swap(pendingRuns);
+            dirty = false;
+            writing = true;
+            lock.unlock();
+            
+            if (!runs.empty() && !history.append(runs.data(), runs.size())) {
+                std::cerr << "Warning: failed to append to " << historyPath(filename) << std::endl;
+            }
+            bool ok = writeFile(snapshot);
+            if (!ok) std::cerr << "Warning: failed to save " << filename << std::endl;
+            else if (gameLogEnabled()) std::cout << "Game data saved!" << std::endl;
+            
+            lock.lock();
+            writing = false;
+            saveDone.notify_all();
+        }
     }
     
+    // Queue the current data for the save thread; never blocks on disk
+    void save() {
+        std::lock_guard<std::mutex> lock(saveMutex);
+        pending = data;
+        dirty = true;
+        saveWake.notify_one();
+    }
+    
+    // Constructor only: the save thread owns the history afterwards
     void load() {
         std::ifstream inFile(filename);
-        if (inFile.is_open()) {
+        bool found = inFile.is_open();
+        if (found) {
             std::string content((std::istreambuf_iterator<char>(inFile)),
                                std::istreambuf_iterator<char>());
             parseJSON(content);
             inFile.close();
+        }
+        
+        // A new log starts from the JSON totals; afterwards the log wins
+        if (history.open(historyPath(filename), data.bestScore, data.totalCoins)) {
+            runCount = history.getRunCount();
+            data.bestScore = history.getBestScore();
+            data.totalCoins = (int)history.getTotalCoins();
+        } else {
+            std::cerr << "Warning: cannot open " << historyPath(filename) << ", runs will not be kept" << std::endl;
+        }
+        
+        if (!gameLogEnabled()) return;
+        if (found || runCount > 0) {
             std::cout << "Loaded game data: Best Score = " << data.bestScore 
-                     << ", Total Coins = " << data.totalCoins << std::endl;
+                     << ", Total Coins = " << data.totalCoins
+                     << ", Runs = " << runCount << std::endl;
         } else {
             std::cout << "No save file found, starting fresh" << std::endl;
         }
     }
     
-    void save() {
-        std::ofstream outFile(filename);
-        if (outFile.is_open()) {
-            outFile << toJSON();
-            outFile.close();
-            std::cout << "Game data saved!" << std::endl;
+    // gamedata.json -> gamedata.runs
+    static std::string historyPath(const std::string& file) {
+        const std::string ext = ".json";
+        if (file.size() > ext.size() && file.compare(file.size() - ext.size(), ext.size(), ext) == 0) {
+            return file.substr(0, file.size() - ext.size()) + ".runs";
         }
+        return file + ".runs";
     }
     
-    void updateBestScore(int score) {
-        if (score > data.bestScore) {
-            data.bestScore = score;
-            save();
+public:
+    ScoreManager(const std::string& file = "gamedata.json")
+        : filename(file), runCount(0), dirty(false), writing(false), flushing(false), stopping(false) {
+        load();
+        saveThread = std::thread(&ScoreManager::saveLoop, this);
+    }
+    
+    ~ScoreManager() {
+        {
+            std::lock_guard<std::mutex> lock(saveMutex);
+            stopping = true;
+            saveWake.notify_one();
         }
+        saveThread.join();   // writes anything still dirty before exiting
     }
     
-    void addCoins(int coins) {
-        data.totalCoins += coins;
-        save();
+    ScoreManager(const ScoreManager&) = delete;
+    ScoreManager& operator=(const ScoreManager&) = delete;
+    
+    // Block until every change made so far is on disk
+    void flush() {
+        std::unique_lock<std::mutex> lock(saveMutex);
+        flushing = true;
+        saveWake.notify_one();
+        saveDone.wait(lock, [this] { return !dirty && !writing; });
+        flushing = false;
+    }
+    
+    // Record a finished run; best score and coin total follow from it
+    void recordRun(const RunRecord& run) {
+        if (run.score > data.bestScore) data.bestScore = run.score;
+        data.totalCoins += run.score;
+        runCount++;
+        
+        std::lock_guard<std::mutex> lock(saveMutex);
+        pendingRuns.push_back(run);
+        pending = data;
+        dirty = true;
+        saveWake.notify_one();
     }
     
     void setSelectedCharacter(int character) {
@@ -100,4 +228,5 @@ public:
     int getBestScore() const { return data.bestScore; }
     int getTotalCoins() const { return data.totalCoins; }
     int getSelectedCharacter() const { return data.selectedCharacter; }
+    uint32_t getRunCount() const { return runCount; }
 };
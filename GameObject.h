@@ -1,24 +1,160 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include "SimdKernels.h"
+
 struct Metro {
     float x, y, width;
     bool active;
     Metro(float _x, float _y, float _w) : x(_x), y(_y), width(_w), active(true) {}
 };
 
-struct Obstacle {
-    float x, y, width, height;
-    bool isFlying;
-    bool active;
-    Obstacle(float _x, float _y, float _w, float _h, bool flying) 
-        : x(_x), y(_y), width(_w), height(_h), isFlying(flying), active(true) {}
+// Per-entity flag bits stored in EntityRing::flags
+enum EntityFlag : uint8_t {
+    ENTITY_FLYING = 1 << 0,      // obstacle: aerial instead of ground
+    ENTITY_COLLECTED = 1 << 1    // coin: already picked up, waiting to despawn
 };
 
-struct Coin {
-    float x, y, size;
-    bool collected;
-    Coin(float _x, float _y) : x(_x), y(_y), size(20), collected(false) {}
+// Fixed-capacity FIFO of axis-aligned entities in structure-of-arrays layout.
+// Obstacles and coins spawn at the right edge and leave at the left in the
+// same order, so despawning is just advancing the head. Nothing allocates
+// after construction.
+//
+// Entities must be pushed in non-decreasing x. Everything scrolls by the
+// same amount, so the ring stays sorted by x from head to tail and range
+// queries can binary-search instead of scanning (see firstCandidate).
+template <int Capacity>
+struct EntityRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "EntityRing capacity must be a power of two");
+    static_assert(Capacity % 8 == 0, "EntityRing capacity must be whole SIMD blocks");
+    static const int CAPACITY = Capacity;
+    static const int BLOCKS = Capacity / 8;
+    
+    float x[Capacity];
+    float y[Capacity];
+    float w[Capacity];
+    float h[Capacity];
+    uint8_t flags[Capacity];
+    int head;
+    int count;
+    float maxWidth;   // widest entity pushed since clear(), bounds the query window
+    uint32_t pushes;  // entities pushed since clear(); new ones are the last pushes - seen
+    
+    // Dead slots are scrolled along with live ones in the same SIMD block.
+    // At x = +inf they stay put, never overlap anything and never count as
+    // off screen.
+    static constexpr float DEAD_X = std::numeric_limits<float>::infinity();
+    
+    EntityRing() : y(), w(), h(), flags(), head(0), count(0), maxWidth(0), pushes(0) {
+        std::fill(x, x + Capacity, DEAD_X);
+    }
+    
+    void clear() {
+        for (int i = 0; i < count; i++) x[slot(i)] = DEAD_X;
+        head = 0;
+        count = 0;
+        maxWidth = 0;
+        pushes = 0;
+    }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == Capacity; }
+    
+    // Array index of the i-th live entity, oldest (leftmost) first
+    int slot(int i) const { return (head + i) & (Capacity - 1); }
+    
+    // Returns false (and drops the entity) when the ring is full
+    bool push(float ex, float ey, float ew, float eh, uint8_t eflags) {
+        if (full()) return false;
+        int s = slot(count);
+        x[s] = ex;
+        y[s] = ey;
+        w[s] = ew;
+        h[s] = eh;
+        flags[s] = eflags;
+        count++;
+        pushes++;
+        if (ew > maxWidth) maxWidth = ew;
+        return true;
+    }
+    
+    // First live position (0 = head) whose entity could reach past 'left',
+    // i.e. the first with x > left - maxWidth. Walk forward from here and
+    // stop at the first entity with x >= the query's right edge.
+    int firstCandidate(float left) const {
+        float bound = left - maxWidth;
+        int lo = 0, hi = count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (x[slot(mid)] > bound) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+    
+    void popFront() {
+        x[head] = DEAD_X;
+        head = (head + 1) & (Capacity - 1);
+        count--;
+    }
+    
+    // Scroll every live entity left by dx and test it against 'box', one
+    // aligned block of 8 slots at a time, walking from the head's block.
+    // Dead slots hold DEAD_X, which never hits and never leaves, so no lane
+    // masking is needed. hitMasks[block] is written only for blocks with a
+    // hit, and bit b of hitBlocks says which ones. 'leaving' counts entities
+    // that scrolled off the left; they are always a prefix from the head
+    // because the ring is sorted by x.
+    struct ScrollResult {
+        int leaving;
+        uint32_t hitBlocks;
+    };
+    
+    ScrollResult scrollAndCollide(float dx, const SimdBox& box, uint8_t hitMasks[BLOCKS]) {
+        static_assert(BLOCKS <= 32, "hitBlocks holds one bit per block");
+        ScrollResult result = {0, 0};
+        int blocks = ((head & 7) + count + 7) / 8;
+        if (blocks > BLOCKS) blocks = BLOCKS;
+        
+        for (int k = 0; k < blocks; k++) {
+            int block = ((head >> 3) + k) & (BLOCKS - 1);
+            int base = block * 8;
+            SimdMasks masks = scrollAndCollide8(x + base, y + base, w + base, h + base, dx, box);
+            if (masks.hit) {
+                hitMasks[block] = masks.hit;
+                result.hitBlocks |= 1u << block;
+            }
+            for (uint32_t gone = ~(uint32_t)masks.active & 0xFFu; gone; gone &= gone - 1) {
+                result.leaving++;
+            }
+        }
+        return result;
+    }
+    
+    // Live entries as at most two contiguous index ranges [begin, end).
+    // Returns the number of ranges.
+    int spans(int begin[2], int end[2]) const {
+        if (count == 0) return 0;
+        begin[0] = head;
+        if (head + count <= Capacity) {
+            end[0] = head + count;
+            return 1;
+        }
+        end[0] = Capacity;
+        begin[1] = 0;
+        end[1] = head + count - Capacity;
+        return 2;
+    }
+    
 };
 
+typedef EntityRing<64> ObstacleRing;
+typedef EntityRing<128> CoinRing;
+
+// Coins are square
+const float COIN_SIZE = 20;
+
 #endif
@@ -0,0 +1,133 @@
+#ifndef GAME_OPTIONS_H
+#define GAME_OPTIONS_H
+
+/**
+ * GameOptions
+ * ===========
+ *
+ * PURPOSE:
+ * Command-line settings for the windowed game, parsed once in main() and
+ * handed to Game. No GL or GLFW dependencies.
+ *
+ * USAGE:
+ *   ./metro_runner [--pacing vsync|off|cap|low-latency] [--fps N]
+ *                  [--seed S] [--record file] [--replay file] [--dynamic-res]
+ *                  [--gpu-world] [--threaded]
+ *
+ *   --pacing  how frames are paced while playing (default vsync):
+ *             vsync        swap interval 1
+ *             off          swap interval 0, run as fast as possible
+ *             cap          swap interval 0, precise sleep to --fps
+ *             low-latency  swap interval 1, but sample input and simulate
+ *                          as late as possible before the next vblank
+ *   --fps     frame rate for cap mode (default: monitor refresh rate)
+ *   --seed    world seed for every run (default: a fresh seed per run)
+ *   --record  write each finished run as an InputRecording (the last run
+ *             played wins; a run cut short by quitting is saved too)
+ *   --replay  skip the menus and play back a recording in real time
+ *   --dynamic-res  lower the internal resolution below the virtual
+ *             1200x800 while the scene misses its GPU budget (VirtualScreen)
+ *   --gpu-world  keep metros, obstacles and coins in a GPU buffer and move
+ *             them with one scroll uniform (WorldBuffer)
+ *   --threaded  simulate on a thread of its own and render its latest
+ *             snapshot (SimThread); --gpu-world is ignored with it, since
+ *             WorldBuffer reads the live GameWorld
+ *
+ * USED BY:
+ * - main.cpp (parse), Game (pacing, seeds, record/replay, resolution,
+ *   threading)
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+enum class PacingMode {
+    VSYNC,
+    OFF,
+    CAP,
+    LOW_LATENCY
+};
+
+inline const char* pacingModeName(PacingMode mode) {
+    switch (mode) {
+        case PacingMode::VSYNC: return "vsync";
+        case PacingMode::OFF: return "off";
+        case PacingMode::CAP: return "cap";
+        case PacingMode::LOW_LATENCY: return "low-latency";
+    }
+    return "?";
+}
+
+inline bool parsePacingMode(const std::string& name, PacingMode& out) {
+    if (name == "vsync") out = PacingMode::VSYNC;
+    else if (name == "off") out = PacingMode::OFF;
+    else if (name == "cap") out = PacingMode::CAP;
+    else if (name == "low-latency") out = PacingMode::LOW_LATENCY;
+    else return false;
+    return true;
+}
+
+struct GameOptions {
+    PacingMode pacing;
+    int fpsCap;              // 0 = use the monitor refresh rate
+    bool fixedSeed;
+    uint64_t seed;
+    std::string recordPath;
+    std::string replayPath;
+    bool dynamicResolution;
+    bool gpuWorld;
+    bool threaded;
+
+    GameOptions() : pacing(PacingMode::VSYNC), fpsCap(0), fixedSeed(false), seed(0),
+                    dynamicResolution(false), gpuWorld(false), threaded(false) {}
+
+    static void printUsage(const char* program) {
+        std::cerr << "Usage: " << program << " [--pacing vsync|off|cap|low-latency] [--fps N]"
+                  << " [--seed S] [--record file] [--replay file] [--dynamic-res] [--gpu-world] [--threaded]" << std::endl;
+    }
+
+    // Returns false (after printing why) on anything it does not understand
+    static bool parse(int argc, char** argv, GameOptions& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--pacing" && hasValue) {
+                if (!parsePacingMode(argv[++i], options.pacing)) {
+                    std::cerr << "Unknown pacing mode: " << argv[i] << std::endl;
+                    return false;
+                }
+            } else if (arg == "--fps" && hasValue) {
+                options.fpsCap = std::atoi(argv[++i]);
+                if (options.fpsCap <= 0) {
+                    std::cerr << "--fps needs a positive number" << std::endl;
+                    return false;
+                }
+            } else if (arg == "--seed" && hasValue) {
+                options.fixedSeed = true;
+                options.seed = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--record" && hasValue) {
+                options.recordPath = argv[++i];
+            } else if (arg == "--replay" && hasValue) {
+                options.replayPath = argv[++i];
+            } else if (arg == "--dynamic-res") {
+                options.dynamicResolution = true;
+            } else if (arg == "--gpu-world") {
+                options.gpuWorld = true;
+            } else if (arg == "--threaded") {
+                options.threaded = true;
+            } else {
+                printUsage(argv[0]);
+                return false;
+            }
+        }
+        if (options.threaded && options.gpuWorld) {
+            std::cerr << "--gpu-world is ignored with --threaded" << std::endl;
+            options.gpuWorld = false;
+        }
+        return true;
+    }
+};
+
+#endif
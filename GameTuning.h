@@ -0,0 +1,91 @@
+#ifndef GAME_TUNING_H
+#define GAME_TUNING_H
+
+/**
+ * GameTuning
+ * ==========
+ *
+ * PURPOSE:
+ * The difficulty constants in one place: the gameSpeed ramp, spawn
+ * intervals, metro gaps and ability timings. The defaults are the game's own values,
+ * so a default-constructed GameTuning plays exactly like the game and
+ * replays stay valid. batch_sim overrides fields to try other curves.
+ *
+ * FIELDS:
+ * - startSpeed, speedStep, speedInterval: gameSpeed begins at startSpeed
+ *   and gains speedStep every speedInterval seconds, without limit
+ * - obstacleInterval, coinInterval: seconds between spawns (rounded to
+ *   whole ticks by SegmentGenerator)
+ * - metroGapMin, metroGapMax: each recycled metro's gap is drawn in whole
+ *   pixels from this range (the game's is 80..80, a fixed gap)
+ * - abilityDuration[character], abilityCooldown: seconds
+ *
+ * OVERRIDES:
+ * set("speed_step", 0.75f) etc.; keyNames() lists every key. Returns false
+ * for an unknown key or a value that would stall the game (zero intervals,
+ * no speed, a slowing ramp). Spawn intervals also have a floor that depends
+ * on startSpeed and the gap range must not be empty, so check the finished
+ * struct with GameWorld::tuningProblem.
+ *
+ * USED BY:
+ * - Simulation (hands it to GameWorld and Player::activateAbility)
+ * - batch_sim (--tune key=value)
+ *
+ * DEPENDENCIES:
+ * - None
+ */
+
+#include <string>
+
+struct GameTuning {
+    static const int CHARACTERS = 4;
+
+    float startSpeed;
+    float speedStep;
+    float speedInterval;
+    float obstacleInterval;
+    float coinInterval;
+    float metroGapMin;
+    float metroGapMax;
+    float abilityDuration[CHARACTERS];   // shield, double jump, magnet, dash
+    float abilityCooldown;
+
+    GameTuning() : startSpeed(3.0f), speedStep(0.5f), speedInterval(10.0f),
+        obstacleInterval(2.0f), coinInterval(1.5f), metroGapMin(80.0f), metroGapMax(80.0f),
+        abilityCooldown(8.0f) {
+        abilityDuration[0] = 5.0f;
+        abilityDuration[1] = 8.0f;
+        abilityDuration[2] = 6.0f;
+        abilityDuration[3] = 5.0f;
+    }
+
+    // The game's values; Player falls back to these when given no tuning
+    static const GameTuning& defaults() {
+        static const GameTuning tuning;
+        return tuning;
+    }
+
+    static const char* keyNames() {
+        return "start_speed speed_step speed_interval obstacle_interval coin_interval metro_gap_min metro_gap_max "
+               "shield_duration double_jump_duration magnet_duration dash_duration ability_cooldown";
+    }
+
+    bool set(const std::string& key, float value) {
+        if (key == "start_speed" && value > 0) startSpeed = value;
+        else if (key == "speed_step" && value >= 0) speedStep = value;
+        else if (key == "speed_interval" && value > 0) speedInterval = value;
+        else if (key == "obstacle_interval" && value > 0) obstacleInterval = value;
+        else if (key == "coin_interval" && value > 0) coinInterval = value;
+        else if (key == "metro_gap_min" && value >= 0) metroGapMin = value;
+        else if (key == "metro_gap_max" && value >= 0) metroGapMax = value;
+        else if (key == "shield_duration") abilityDuration[0] = value;
+        else if (key == "double_jump_duration") abilityDuration[1] = value;
+        else if (key == "magnet_duration") abilityDuration[2] = value;
+        else if (key == "dash_duration") abilityDuration[3] = value;
+        else if (key == "ability_cooldown") abilityCooldown = value;
+        else return false;
+        return true;
+    }
+};
+
+#endif
@@ -18,53 +18,202 @@
  * - Track coin collection with ability bonuses
  * 
  * GAME MECHANICS:
- * - 8 metro platforms with 80px gaps, 350px width each
+ * - 8 metro platforms, 350px width each, with 80px gaps (GameTuning's
+ *   metro gap range; the opening layout uses its minimum)
  * - Platform Y position: 500px from top
  * - Game speed starts at 3.0, increases by 0.5 every 10s
  * - Obstacles spawn every 2 seconds (50% flying, 50% ground)
  * - Coins spawn every 1.5 seconds at random heights
+ * - Those numbers are GameTuning's defaults; batch_sim tries others
+ *   (tuningProblem rejects spawn rates the track storage cannot hold)
+ * - What spawns (and each recycled metro's gap) comes from TrackSegments
+ *   built by SegmentGenerator from the session seed, inline or ahead of
+ *   time on its worker; the tick only reads the current segment. A seed
+ *   plus the input stream reproduces a run exactly either way.
  * - Effective speed affected by player abilities
+ * - All movement is per fixed simulation tick (60 ticks/s, see Game)
+ * 
+ * ENTITY STORAGE:
+ * - Obstacles and coins live in fixed-capacity ring buffers (EntityRing)
+ *   with separate x/y/w/h/flag arrays
+ * - They spawn at the right and leave at the left in order, so despawning
+ *   advances the ring head; no allocation happens per frame or on restart
+ * - Collected coins are flagged and skipped until they reach the head
+ * - scrollDistance, generation and EntityRing::pushes let WorldBuffer keep
+ *   a GPU copy in world space and upload only new entities
+ * - getStats() counts live entities per kind (profiling overlay)
  * 
  * COLLISION DETECTION:
+ * - Per tick, obstacles and coins are scrolled and tested against the
+ *   player by the SIMD kernel (SimdKernels.h), 8 ring slots at a time;
+ *   its hit masks drive coin pickup and the obstacle hit flag
+ * - Broadphase: entities stay sorted by x, so queries binary-search to the
+ *   player's position and only test the few entities in that window
+ * - Metros are a circular list ordered from metroTail + 1; the recycler
+ *   appends after metroTail directly instead of rescanning for max x
+ * - Swept along the scroll axis: an obstacle or coin that passed through
+ *   the player within one step still hits, and a gap that passed under the
+ *   player's center still takes the ground away for that tick. Both need
+ *   more than 60-80 px per tick, so at normal speeds results are exactly
+ *   those of the discrete tests. Vertical motion is bounded by gravity and
+ *   jump strength, far below the entity heights, so it stays discrete.
  * - Platform detection uses player center X position
- * - Obstacle collision with invincibility check
+ * - Obstacle collision from the kernel's hit mask, with invincibility check
  * - Fall detection when player drops below platform level
  * 
  * USED BY:
  * - Game class (updates world each frame, queries collision state)
  * 
  * DEPENDENCIES:
- * - GameObject.h for entity structs (Metro, Obstacle, Coin)
+ * - GameObject.h for Metro and the EntityRing obstacle/coin storage
  * - Player.h for player state and ability queries
+ * - GameConfig.h for screen size (no GL, so the world builds headless)
+ * - GameTuning.h for the speed ramp and spawn intervals
+ * - SegmentGenerator.h for upcoming track content
  */
 
 #include <vector>
 #include <algorithm>
-#include <cstdlib>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
 #include "GameObject.h"
 #include "Player.h"
-#include "Renderer2D.h"
+#include "GameConfig.h"
+#include "GameTuning.h"
+#include "SegmentGenerator.h"
+
+// Entities alive in a world (GameWorld::getStats). Collected coins count
+// until they reach the ring head and despawn.
+struct WorldStats {
+    int metros;
+    int obstacles;
+    int coins;
+    
+    int total() const { return metros + obstacles + coins; }
+};
 
 class GameWorld {
 private:
     std::vector<Metro> metros;
-    std::vector<Obstacle> obstacles;
-    std::vector<Coin> coins;
+    int metroTail;          // index of the rightmost metro
+    float maxMetroWidth;
+    ObstacleRing obstacles;
+    CoinRing coins;
     
     float metroY;
     float metroGap;
+    float startSpeed;
+    float speedStep;
+    float speedInterval;
     float gameSpeed;
     float speedIncreaseTimer;
     int coinsCollected;
     
-    float obstacleTimer;
-    float coinTimer;
+    // Track content: the segment covering the current tick
+    SegmentGenerator generator;
+    TrackSegment segment;
+    int32_t worldTick;      // updates since init(), from 1
+    int nextObstacle;       // cursors into segment
+    int nextCoin;
+    int nextMetroGap;
+    
+    float lastScrollStep;   // distance everything moved left in the last tick
+    double scrollDistance;  // sum of all scroll steps since init()
+    uint32_t generation;    // bumped by init(), so observers can spot a new world
+    bool obstacleHit;       // an obstacle overlapped the player in the last tick
+    uint64_t seed;
+    
+    static TrackLayout trackLayout(float groundY, const GameTuning& tuning) {
+        TrackLayout layout = {groundY, tuning.metroGapMin, tuning.metroGapMax,
+                              tuning.obstacleInterval, tuning.coinInterval};
+        return layout;
+    }
+    
+    // Move on to the next segment once the tick has left the current one
+    void advanceSegment() {
+        if (worldTick <= (int32_t)((segment.index + 1) * TrackSegment::SEGMENT_TICKS)) return;
+        segment = generator.next(segment.index + 1);
+        nextObstacle = 0;
+        nextCoin = 0;
+        nextMetroGap = 0;
+    }
+    
+    // Spawn points and widths; entities live until their right edge passes 0
+    static constexpr float OBSTACLE_SPAWN_X = SCREEN_WIDTH + 50;
+    static constexpr float OBSTACLE_WIDTH = 40;
+    static constexpr float COIN_SPAWN_X = SCREEN_WIDTH + 30;
+    
+    // Shortest spawn period (ticks) that neither a segment's spawn list nor
+    // the ring can drop entities at: ceil(SEGMENT_TICKS / perSegment), and
+    // at most capacity - 1 entities over a lifetime at the slowest speed
+    static int minSpawnPeriod(int perSegment, int ringCapacity, float travel, float slowestSpeed) {
+        int segmentBound = (TrackSegment::SEGMENT_TICKS + perSegment - 1) / perSegment;
+        int lifetime = (int)std::ceil(travel / slowestSpeed) + 1;
+        int ringBound = (lifetime + ringCapacity - 2) / (ringCapacity - 1);
+        return std::max(segmentBound, ringBound);
+    }
+    
+    static void describeSpawnLimit(std::ostringstream& out, const char* key, float interval, int minPeriod) {
+        out << key << " " << interval << " spawns every " << SegmentGenerator::spawnPeriod(interval, SIM_DT)
+            << " ticks, the track holds at most one per " << minPeriod << " (use " << key << " >= "
+            << std::ceil(minPeriod * SIM_DT * 100) / 100 << ")";
+    }
+    
+    static SimdBox playerBox(const Player& player) {
+        SimdBox box = {player.x, player.y, player.width, player.height};
+        return box;
+    }
     
 public:
-    GameWorld() : metroY(500), metroGap(80), gameSpeed(3.0f), 
-        speedIncreaseTimer(0), coinsCollected(0), obstacleTimer(0), coinTimer(0) {}
+    // Other tunings are for benchmarks and batch_sim; the game uses the defaults
+    explicit GameWorld(const GameTuning& tuning = GameTuning())
+        : metroTail(0), maxMetroWidth(0), metroY(500), metroGap(tuning.metroGapMin), startSpeed(tuning.startSpeed),
+        speedStep(tuning.speedStep), speedInterval(tuning.speedInterval), gameSpeed(startSpeed),
+        speedIncreaseTimer(0), coinsCollected(0),
+        generator(trackLayout(metroY, tuning)),
+        worldTick(0), nextObstacle(0), nextCoin(0), nextMetroGap(0),
+        lastScrollStep(0), scrollDistance(0), generation(0), obstacleHit(false), seed(0) {
+        segment.index = -1;
+    }
+    
+    // Why the track could not be built as 'tuning' asks, or "" if it can.
+    // Spawns denser than the segment lists and rings hold would be dropped
+    // without a trace, so batch_sim refuses such tunings. Speed never drops
+    // below startSpeed (GameTuning rejects negative steps, abilities only
+    // speed up), so that is where entities live longest.
+    static std::string tuningProblem(const GameTuning& tuning) {
+        int obstacleMin = minSpawnPeriod(TrackSegment::MAX_OBSTACLES, ObstacleRing::CAPACITY,
+                                         OBSTACLE_SPAWN_X + OBSTACLE_WIDTH, tuning.startSpeed);
+        int coinMin = minSpawnPeriod(TrackSegment::MAX_COINS, CoinRing::CAPACITY,
+                                     COIN_SPAWN_X + COIN_SIZE, tuning.startSpeed);
+        std::ostringstream out;
+        if (tuning.metroGapMax < tuning.metroGapMin) {
+            out << "metro_gap_max " << tuning.metroGapMax << " is below metro_gap_min " << tuning.metroGapMin;
+        } else if (SegmentGenerator::spawnPeriod(tuning.obstacleInterval, SIM_DT) < obstacleMin) {
+            describeSpawnLimit(out, "obstacle_interval", tuning.obstacleInterval, obstacleMin);
+        } else if (SegmentGenerator::spawnPeriod(tuning.coinInterval, SIM_DT) < coinMin) {
+            describeSpawnLimit(out, "coin_interval", tuning.coinInterval, coinMin);
+        }
+        return out.str();
+    }
+    
+    GameWorld(const GameWorld&) = delete;
+    GameWorld& operator=(const GameWorld&) = delete;
+    
+    // Build segments ahead on a background thread (interactive game)
+    void startSegmentWorker() { generator.startWorker(); }
     
-    void init() {
+    void init(uint64_t sessionSeed) {
+        seed = sessionSeed;
+        generator.restart(seed);
+        segment = generator.next(0);
+        worldTick = 0;
+        nextObstacle = 0;
+        nextCoin = 0;
+        nextMetroGap = 0;
         metros.clear();
         obstacles.clear();
         coins.clear();
@@ -73,126 +222,167 @@ public:
         for (int i = 1; i < 8; i++) {
             metros.push_back(Metro(600 + (i-1) * (350 + metroGap), metroY, 350));
         }
+        metroTail = (int)metros.size() - 1;
+        maxMetroWidth = 600;
         
-        gameSpeed = 3.0f;
+        gameSpeed = startSpeed;
         speedIncreaseTimer = 0;
         coinsCollected = 0;
-        obstacleTimer = 0;
-        coinTimer = 0;
+        lastScrollStep = 0;
+        scrollDistance = 0;
+        generation++;
+        obstacleHit = false;
     }
     
     void update(float deltaTime, Player& player) {
+        worldTick++;
+        advanceSegment();
+        
         speedIncreaseTimer += deltaTime;
         
-        if (speedIncreaseTimer >= 10.0f) {
-            gameSpeed += 0.5f;
+        if (speedIncreaseTimer >= speedInterval) {
+            gameSpeed += speedStep;
             speedIncreaseTimer = 0;
-            std::cout << "Speed increased! Speed: " << gameSpeed << std::endl;
+            if (gameLogEnabled()) {
+                std::cout << "Speed increased! Speed: " << gameSpeed << std::endl;
+            }
         }
         
         updateMetros(player);
-        updateObstacles(deltaTime, player);
-        updateCoins(deltaTime, player);
+        updateObstacles(player);
+        updateCoins(player);
     }
     
     void updateMetros(Player& player) {
         float effectiveSpeed = gameSpeed * player.getSpeedMultiplier() * player.getPlayerSpeedMultiplier();
+        lastScrollStep = effectiveSpeed;
+        scrollDistance += effectiveSpeed;
         
-        for (auto& metro : metros) {
+        for (int i = 0; i < (int)metros.size(); i++) {
+            Metro& metro = metros[i];
             metro.x -= effectiveSpeed;
             if (metro.x + metro.width < -50) {
-                float maxX = -1000;
-                for (const auto& m : metros) {
-                    if (m.x > maxX) maxX = m.x;
-                }
-                metro.x = maxX + 350 + metroGap;
+                float gap = segment.metroGaps[nextMetroGap++ % TrackSegment::METRO_GAPS];
+                metro.x = metros[metroTail].x + 350 + gap;
+                metroTail = i;
             }
         }
     }
     
-    void updateObstacles(float deltaTime, Player& player) {
-        obstacleTimer += deltaTime;
-        
-        if (obstacleTimer > 2.0f) {
-            bool flying = rand() % 2 == 0;
-            float obsX = SCREEN_WIDTH + 50;
+    void updateObstacles(Player& player) {
+        if (nextObstacle < segment.obstacleCount && segment.obstacles[nextObstacle].tick == worldTick) {
+            bool flying = segment.obstacles[nextObstacle++].flying;
             float obsY = flying ? metroY - 180 : metroY - 60;
             float obsH = flying ? 30 : 60;
-            obstacles.push_back(Obstacle(obsX, obsY, 40, obsH, flying));
-            obstacleTimer = 0;
+            obstacles.push(OBSTACLE_SPAWN_X, obsY, OBSTACLE_WIDTH, obsH, flying ? ENTITY_FLYING : 0);
         }
         
         float effectiveSpeed = gameSpeed * player.getSpeedMultiplier() * player.getPlayerSpeedMultiplier();
-        for (auto& obs : obstacles) {
-            obs.x -= effectiveSpeed;
-            if (obs.x + obs.width < 0) obs.active = false;
-        }
+        SimdBox box = playerBox(player);
+        
+        uint8_t hits[ObstacleRing::BLOCKS];
+        ObstacleRing::ScrollResult result = obstacles.scrollAndCollide(effectiveSpeed, box, hits);
+        obstacleHit = result.hitBlocks != 0;
         
-        obstacles.erase(std::remove_if(obstacles.begin(), obstacles.end(), 
-            [](const Obstacle& o) { return !o.active; }), obstacles.end());
+        for (int i = 0; i < result.leaving; i++) {
+            obstacles.popFront();
+        }
     }
     
-    void updateCoins(float deltaTime, Player& player) {
-        coinTimer += deltaTime;
-        
-        if (coinTimer > 1.5f) {
-            float coinY = metroY - 150 - rand() % 100;
-            coins.push_back(Coin(SCREEN_WIDTH + 30, coinY));
-            coinTimer = 0;
+    void updateCoins(Player& player) {
+        if (nextCoin < segment.coinCount && segment.coins[nextCoin].tick == worldTick) {
+            coins.push(COIN_SPAWN_X, segment.coins[nextCoin++].y, COIN_SIZE, COIN_SIZE, 0);
         }
         
         float effectiveSpeed = gameSpeed * player.getSpeedMultiplier() * player.getPlayerSpeedMultiplier();
-        for (auto& coin : coins) {
-            coin.x -= effectiveSpeed;
-            
-            if (!coin.collected && 
-                player.x < coin.x + coin.size && player.x + player.width > coin.x &&
-                player.y < coin.y + coin.size && player.y + player.height > coin.y) {
-                coin.collected = true;
-                int coinValue = player.hasDoubleCoinBonus() ? 2 : 1;
-                coinsCollected += coinValue;
+        SimdBox box = playerBox(player);
+        int coinValue = player.hasDoubleCoinBonus() ? 2 : 1;
+        
+        // Pickup straight from the hit masks; usually no bits are set
+        uint8_t hits[CoinRing::BLOCKS];
+        CoinRing::ScrollResult result = coins.scrollAndCollide(effectiveSpeed, box, hits);
+        for (uint32_t blocks = result.hitBlocks; blocks; blocks &= blocks - 1) {
+            int b = __builtin_ctz(blocks);
+            uint32_t bits = hits[b];
+            while (bits) {
+                int i = b * 8 + __builtin_ctz(bits);
+                bits &= bits - 1;
+                if (!(coins.flags[i] & ENTITY_COLLECTED)) {
+                    coins.flags[i] |= ENTITY_COLLECTED;
+                    coinsCollected += coinValue;
+                }
             }
         }
         
-        coins.erase(std::remove_if(coins.begin(), coins.end(), 
-            [](const Coin& c) { return c.x + c.size < 0 || c.collected; }), coins.end());
+        while (!coins.empty() &&
+               (coins.x[coins.head] + coins.w[coins.head] < 0 || (coins.flags[coins.head] & ENTITY_COLLECTED))) {
+            coins.popFront();
+        }
+    }
+    
+    // Metro at circular position n, leftmost first
+    const Metro& metroAt(int n) const {
+        int i = metroTail + 1 + n;
+        int count = (int)metros.size();
+        return metros[i >= count ? i - count : i];
+    }
+    
+    // Is point x over any metro? Binary-search the last metro starting left
+    // of x, then step back while an earlier (wider) one could still reach it.
+    bool isOverMetro(float px) const {
+        int lo = 0, hi = (int)metros.size();
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (metroAt(mid).x < px) lo = mid + 1;
+            else hi = mid;
+        }
+        for (int n = lo - 1; n >= 0; n--) {
+            const Metro& metro = metroAt(n);
+            if (metro.x <= px - maxMetroWidth) break;
+            if (px > metro.x && px < metro.x + metro.width) return true;
+        }
+        return false;
+    }
+    
+    // Did a whole gap pass under point x during the last scroll step? The
+    // gap in front of the last metro starting left of x is left of x now
+    // and was fully right of it before the step. Needs a step wider than
+    // the gap (80 px in the game), so at normal speeds this is always false.
+    bool gapCrossedUnder(float px) const {
+        int lo = 0, hi = (int)metros.size();
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (metroAt(mid).x < px) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < 2) return false;
+        const Metro& before = metroAt(lo - 2);
+        float gapLeft = before.x + before.width;
+        return gapLeft < metroAt(lo - 1).x && px < gapLeft + lastScrollStep;
     }
     
+    // A gap that scrolled past entirely within one tick still counts as
+    // stepping off the platform (swept platform edges)
     bool isPlayerOnPlatform(const Player& player) const {
         float groundY = metroY - player.height;
         
         if (player.y >= groundY - 5) {
-            for (const auto& metro : metros) {
-                float playerCenterX = player.x + player.width / 2;
-                if (playerCenterX > metro.x && playerCenterX < metro.x + metro.width) {
-                    return true;
-                }
-            }
+            float px = player.x + player.width / 2;
+            return isOverMetro(px) && !gapCrossedUnder(px);
         }
         return false;
     }
     
-    bool checkObstacleCollision(const Player& player) const {
-        if (player.isInvincible()) return false;
-        
-        for (const auto& obs : obstacles) {
-            if (player.x < obs.x + obs.width && player.x + player.width > obs.x &&
-                player.y < obs.y + obs.height && player.y + player.height > obs.y) {
-                return true;
-            }
-        }
-        return false;
+    // Result of the scroll kernel's (swept) hit mask from the last update();
+    // the only obstacle collision test, so there is one path to keep right
+    bool checkObstacleHitLastTick(const Player& player) const {
+        return obstacleHit && !player.isInvincible();
     }
     
     bool checkFallThrough(const Player& player) const {
-        float playerCenterX = player.x + player.width / 2;
-        
-        for (const auto& metro : metros) {
-            if (playerCenterX > metro.x && playerCenterX < metro.x + metro.width) {
-                return false;
-            }
+        if (isOverMetro(player.x + player.width / 2)) {
+            return false;
         }
-        
         return player.y > metroY + 50;
     }
     
@@ -200,10 +390,29 @@ public:
         return metroY - player.height;
     }
     
+    // Jump to a difficulty tier; it holds for the next speedInterval of ticks (benchmarks)
+    void setGameSpeed(float speed) {
+        gameSpeed = speed;
+        speedIncreaseTimer = 0;
+    }
+    
+    // Also for copies of the world's storage (sim thread snapshots)
+    static WorldStats statsFor(const std::vector<Metro>& metroList, const ObstacleRing& obstacleRing,
+                               const CoinRing& coinRing) {
+        WorldStats stats = {(int)metroList.size(), obstacleRing.size(), coinRing.size()};
+        return stats;
+    }
+    WorldStats getStats() const { return statsFor(metros, obstacles, coins); }
+    
     int getCoinsCollected() const { return coinsCollected; }
+    float getGameSpeed() const { return gameSpeed; }
+    uint64_t getSeed() const { return seed; }
+    float getLastScrollStep() const { return lastScrollStep; }
+    double getScrollDistance() const { return scrollDistance; }
+    uint32_t getGeneration() const { return generation; }
     const std::vector<Metro>& getMetros() const { return metros; }
-    const std::vector<Obstacle>& getObstacles() const { return obstacles; }
-    const std::vector<Coin>& getCoins() const { return coins; }
+    const ObstacleRing& getObstacles() const { return obstacles; }
+    const CoinRing& getCoins() const { return coins; }
 };
 
 #endif
@@ -4,129 +4,198 @@
 /**
  * InputManager Class
  * ==================
- * 
+ *
  * PURPOSE:
- * Handles all keyboard input for the game with proper debouncing to prevent
- * multiple triggers from a single key press.
- * 
+ * Handles all keyboard input for the game. Key changes arrive through the
+ * GLFW key callback as timestamped events, so a tap shorter than a frame is
+ * never lost and each press triggers exactly once.
+ *
  * RESPONSIBILITIES:
- * - Detect key presses from GLFW window
- * - Implement debouncing logic for toggle actions
- * - Provide clean boolean interface for game state queries
- * 
+ * - Receive key events from the GLFW callback (forwarded by Game) into a
+ *   lock-free single-producer/single-consumer queue
+ * - Track which keys are held, including at a given point in time
+ * - Hand out presses (edges) exactly once, optionally only those that
+ *   happened before a given time, so the fixed-timestep loop can assign
+ *   each press to the tick it falls in
+ * - Forward pending events to a second instance that a simulation thread
+ *   consumes (threaded mode, see SimThread)
+ *
  * KEY FEATURES:
- * - Debouncing flags prevent key repeat issues
- * - Separate methods for different input types (jump, ability, navigation)
- * - Works with GLFW window pointer
- * 
+ * - No per-query glfwGetKey polling; "any key" is just "any press event"
+ * - Autorepeat (GLFW_REPEAT) is ignored
+ * - Timestamps are glfwGetTime() seconds, the clock the game loop uses
+ *
+ * FRAME PROTOCOL:
+ * 1. pumpEvents() once per frame, after glfwPollEvents()
+ * 2. Query: is*Pressed() consume presses up to 'until' (default: all)
+ * 3. discardUntil() drops whatever the frame did not consume
+ *
  * USED BY:
- * - Game class (main game loop calls input methods each frame)
- * 
+ * - Game class (menus per frame, jump/ability per simulation tick)
+ * - SimThread (a forwarded instance, jump/ability per tick)
+ *
  * DEPENDENCIES:
- * - GLFW for keyboard input
+ * - GLFW for key codes and the clock
+ * - SpscQueue for the callback -> game loop hand-off
  */
 
 #include <GLFW/glfw3.h>
+#include <limits>
+#include <vector>
+#include "SpscQueue.h"
+
+struct KeyEvent {
+    int key;
+    int action;      // GLFW_PRESS or GLFW_RELEASE
+    double time;     // glfwGetTime() at the callback
+};
 
 class InputManager {
+public:
+    static constexpr double ALL = std::numeric_limits<double>::infinity();
+    
 private:
-    GLFWwindow* window;
+    static const size_t QUEUE_CAPACITY = 256;
     
-    // Debouncing flags
-    bool anyKeyPressed;
-    bool leftPressed;
-    bool rightPressed;
-    bool spacePressed;
-    bool qPressed;
-    bool mPressed;
+    SpscQueue<KeyEvent, QUEUE_CAPACITY> queue;
+    unsigned droppedEvents;                   // callback side, queue was full
     
-public:
-    InputManager(GLFWwindow* win) : window(win), anyKeyPressed(false), 
-        leftPressed(false), rightPressed(false), spacePressed(false),
-        qPressed(false), mPressed(false) {}
+    // Consumer side: key state after every pumped event, plus the events
+    // not yet consumed, oldest first
+    bool keyDown[GLFW_KEY_LAST + 1];
+    std::vector<KeyEvent> events;
     
-    bool isEscapePressed() {
-        return glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS;
+    // Oldest press handed out since takeConsumedPressTime(), for latency
+    double consumedPressTime;
+    bool haveConsumedPress;
+    
+    void noteConsumed(const KeyEvent& e) {
+        if (!haveConsumedPress || e.time < consumedPressTime) consumedPressTime = e.time;
+        haveConsumedPress = true;
     }
     
-    bool isAnyKeyPressed() {
-        bool keyPressed = false;
-        for (int key = 32; key <= 348; key++) {
-            if (glfwGetKey(window, key) == GLFW_PRESS) {
-                keyPressed = true;
-                if (!anyKeyPressed) {
-                    anyKeyPressed = true;
-                    return true;
-                }
-                break;
+    static bool validKey(int key) {
+        return key >= 0 && key <= GLFW_KEY_LAST;
+    }
+    
+    // Take the oldest press of 'key' at or before 'until'
+    bool consumePress(int key, double until) {
+        for (size_t i = 0; i < events.size() && events[i].time <= until; i++) {
+            if (events[i].key == key && events[i].action == GLFW_PRESS) {
+                noteConsumed(events[i]);
+                events.erase(events.begin() + i);
+                return true;
             }
         }
-        if (!keyPressed) {
-            anyKeyPressed = false;
-        }
         return false;
     }
     
-    bool isLeftPressed() {
-        if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS && !leftPressed) {
-            leftPressed = true;
-            return true;
-        }
-        if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_RELEASE) {
-            leftPressed = false;
+    // Was 'key' held at time 'at'? The first pending change after 'at' tells
+    // us what it was before; with none, the latest state holds.
+    bool isDownAt(int key, double at) const {
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].key == key && events[i].time > at) {
+                return events[i].action == GLFW_RELEASE;
+            }
         }
-        return false;
+        return keyDown[key];
     }
     
-    bool isRightPressed() {
-        if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS && !rightPressed) {
-            rightPressed = true;
-            return true;
-        }
-        if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_RELEASE) {
-            rightPressed = false;
-        }
-        return false;
+public:
+    InputManager() : droppedEvents(0), consumedPressTime(0), haveConsumedPress(false) {
+        for (int i = 0; i <= GLFW_KEY_LAST; i++) keyDown[i] = false;
+    }
+    
+    InputManager(const InputManager&) = delete;
+    InputManager& operator=(const InputManager&) = delete;
+    
+    // Called from the GLFW key callback
+    void onKey(int key, int action, double time) {
+        if (!validKey(key) || action == GLFW_REPEAT) return;
+        KeyEvent e = {key, action, time};
+        if (!queue.push(e)) droppedEvents++;
     }
     
-    bool isSpacePressed() {
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && !spacePressed) {
-            spacePressed = true;
-            return true;
+    // Move everything the callback queued into the pending list
+    void pumpEvents() {
+        KeyEvent e;
+        while (queue.pop(e)) {
+            keyDown[e.key] = e.action == GLFW_PRESS;
+            events.push_back(e);
         }
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_RELEASE) {
-            spacePressed = false;
+    }
+    
+    // Hand every pending event to 'other' (which may be pumped on another
+    // thread) and forget them here. Held-key state stays as it is.
+    void forwardTo(InputManager& other) {
+        for (size_t i = 0; i < events.size(); i++) {
+            other.onKey(events[i].key, events[i].action, events[i].time);
         }
-        return false;
+        events.clear();
     }
     
-    bool isJumpPressed() {
-        return glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS || 
-               glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS ||
-               glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    // Start over with the keys 'from' currently holds and nothing pending.
+    // Only while no other thread pumps or feeds this one.
+    void resetFrom(const InputManager& from) {
+        KeyEvent e;
+        while (queue.pop(e)) {}
+        events.clear();
+        for (int i = 0; i <= GLFW_KEY_LAST; i++) keyDown[i] = from.keyDown[i];
+        haveConsumedPress = false;
     }
     
-    bool isAbilityPressed() {
-        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS && !qPressed) {
-            qPressed = true;
-            return true;
-        }
-        if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_RELEASE) {
-            qPressed = false;
-        }
-        return false;
+    // Forget pending events at or before 'time'
+    void discardUntil(double time) {
+        size_t keep = 0;
+        while (keep < events.size() && events[keep].time <= time) keep++;
+        events.erase(events.begin(), events.begin() + keep);
     }
     
-    bool isMutePressed() {
-        if (glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS && !mPressed) {
-            mPressed = true;
-            return true;
-        }
-        if (glfwGetKey(window, GLFW_KEY_M) == GLFW_RELEASE) {
-            mPressed = false;
+    bool isEscapePressed() {
+        return consumePress(GLFW_KEY_ESCAPE, ALL) || keyDown[GLFW_KEY_ESCAPE];
+    }
+    
+    bool isAnyKeyPressed() {
+        for (size_t i = 0; i < events.size(); i++) {
+            if (events[i].action == GLFW_PRESS) {
+                noteConsumed(events[i]);
+                events.erase(events.begin() + i);
+                return true;
+            }
         }
         return false;
     }
+    
+    bool isLeftPressed() { return consumePress(GLFW_KEY_LEFT, ALL); }
+    bool isRightPressed() { return consumePress(GLFW_KEY_RIGHT, ALL); }
+    bool isSpacePressed() { return consumePress(GLFW_KEY_SPACE, ALL); }
+    bool isMutePressed() { return consumePress(GLFW_KEY_M, ALL); }
+    
+    // F3: show/hide debug overlays
+    bool isOverlayTogglePressed() { return consumePress(GLFW_KEY_F3, ALL); }
+    
+    // Held at 'until', or tapped (even briefly) since the last call
+    bool isJumpPressed(double until = ALL) {
+        bool pressed = consumePress(GLFW_KEY_UP, until);
+        pressed = consumePress(GLFW_KEY_W, until) || pressed;
+        pressed = consumePress(GLFW_KEY_SPACE, until) || pressed;
+        return pressed ||
+               isDownAt(GLFW_KEY_UP, until) ||
+               isDownAt(GLFW_KEY_W, until) ||
+               isDownAt(GLFW_KEY_SPACE, until);
+    }
+    
+    bool isAbilityPressed(double until = ALL) { return consumePress(GLFW_KEY_Q, until); }
+    
+    // Timestamp of the oldest press consumed since the last call, if any
+    bool takeConsumedPressTime(double& time) {
+        if (!haveConsumedPress) return false;
+        time = consumedPressTime;
+        haveConsumedPress = false;
+        return true;
+    }
+    
+    unsigned getDroppedEvents() const { return droppedEvents; }
 };
 
 #endif
@@ -0,0 +1,160 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+/**
+ * InputRecording
+ * ==============
+ *
+ * PURPOSE:
+ * Everything needed to re-run one session exactly: the character, the world
+ * seed and the TickInput of every simulation tick. Used to reproduce
+ * reported stutters and as a simulation regression/performance test.
+ *
+ * FILE FORMAT (native endianness):
+ * - ReplayHeader: magic "MRPL", version, character, seed, tick count, and
+ *   the recorded outcome (coins, whether the run ended in a game over)
+ * - One byte per tick: bit 0 jump, bit 1 ability
+ *
+ * DETERMINISM:
+ * Simulation has no other inputs: no wall clock, no global rand(), fixed
+ * SIM_DT. A replay that does not end with the recorded outcome means the
+ * simulation rules changed (or the build differs in floating point).
+ *
+ * USED BY:
+ * - Game (--record / --replay, real time with rendering)
+ * - headless_sim (--record / --replay, as fast as possible)
+ *
+ * DEPENDENCIES:
+ * - Simulation.h for TickInput (no GL)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+
+struct ReplayHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t character;
+    uint32_t gameOver;        // 1 if the recorded run ended by dying
+    uint64_t seed;
+    uint64_t tickCount;
+    int32_t finalCoins;
+    int32_t reserved;
+};
+
+static_assert(sizeof(ReplayHeader) == 40, "ReplayHeader layout is part of the file format");
+
+class InputRecording {
+public:
+    static const uint32_t VERSION = 2;     // 2: track content from SegmentGenerator
+    static const uint64_t MAX_TICKS = 1ULL << 32;    // sanity limit for load()
+
+private:
+    uint64_t seed;
+    int character;
+    std::vector<uint8_t> inputs;
+    int finalCoins;
+    bool gameOver;
+
+public:
+    InputRecording() : seed(0), character(0), finalCoins(0), gameOver(false) {}
+
+    static uint8_t pack(const TickInput& input) {
+        return (uint8_t)((input.jump ? 1 : 0) | (input.ability ? 2 : 0));
+    }
+
+    static TickInput unpack(uint8_t bits) {
+        TickInput input;
+        input.jump = (bits & 1) != 0;
+        input.ability = (bits & 2) != 0;
+        return input;
+    }
+
+    // Recording
+    void begin(uint64_t sessionSeed, int sessionCharacter) {
+        seed = sessionSeed;
+        character = sessionCharacter;
+        inputs.clear();
+        finalCoins = 0;
+        gameOver = false;
+    }
+
+    void record(const TickInput& input) { inputs.push_back(pack(input)); }
+
+    void finish(int coins, bool endedByGameOver) {
+        finalCoins = coins;
+        gameOver = endedByGameOver;
+    }
+
+    bool save(const std::string& path) const {
+        ReplayHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "MRPL", 4);
+        header.version = VERSION;
+        header.character = character;
+        header.gameOver = gameOver ? 1 : 0;
+        header.seed = seed;
+        header.tickCount = inputs.size();
+        header.finalCoins = finalCoins;
+
+        std::string temp = path + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            if (!inputs.empty()) out.write(reinterpret_cast<const char*>(inputs.data()), (std::streamsize)inputs.size());
+            out.close();
+            if (!out) {
+                std::remove(temp.c_str());
+                return false;
+            }
+        }
+        return std::rename(temp.c_str(), path.c_str()) == 0;
+    }
+
+    // Playback
+    bool load(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        ReplayHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+        if (std::memcmp(header.magic, "MRPL", 4) != 0 || header.version != VERSION) return false;
+        if (header.character < 0 || header.character > 3) return false;
+        if (header.tickCount > MAX_TICKS) return false;
+
+        std::vector<uint8_t> data((size_t)header.tickCount);
+        if (!data.empty() && !in.read(reinterpret_cast<char*>(data.data()), (std::streamsize)data.size())) return false;
+
+        seed = header.seed;
+        character = header.character;
+        finalCoins = header.finalCoins;
+        gameOver = header.gameOver != 0;
+        inputs.swap(data);
+        return true;
+    }
+
+    TickInput input(uint64_t tick) const {
+        return tick < inputs.size() ? unpack(inputs[(size_t)tick]) : TickInput();
+    }
+
+    // Did a replayed session end the way the recording did?
+    bool matches(const Simulation& sim) const {
+        return (uint64_t)sim.getTicks() == inputs.size() &&
+               sim.isGameOver() == gameOver &&
+               sim.getWorld().getCoinsCollected() == finalCoins;
+    }
+
+    uint64_t getSeed() const { return seed; }
+    int getCharacter() const { return character; }
+    uint64_t getTickCount() const { return inputs.size(); }
+    int getFinalCoins() const { return finalCoins; }
+    bool endedInGameOver() const { return gameOver; }
+};
+
+#endif
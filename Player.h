@@ -79,9 +79,13 @@
  * 
  * DEPENDENCIES:
  * - iostream for debug output
+ * - GameConfig.h for the console log switch
+ * - GameTuning.h for ability durations and cooldown
  */
 
 #include <iostream>
+#include "GameConfig.h"
+#include "GameTuning.h"
 
 class Player {
 public:
@@ -115,32 +119,33 @@ public:
         else if (headIndex == 1 && isJumping && !hasDoubleJumped && abilityActive) {
             velocityY = -12;
             hasDoubleJumped = true;
-            std::cout << "DOUBLE JUMP!" << std::endl;
+            if (gameLogEnabled()) std::cout << "DOUBLE JUMP!" << std::endl;
         }
     }
     
-    void activateAbility() {
+    void activateAbility(const GameTuning& tuning = GameTuning::defaults()) {
         if (abilityCooldown <= 0) {
             abilityActive = true;
+            // Default durations (GameTuning):
             // Character 0: Shield - 5 seconds invincibility
             // Character 1: Double Jump - 8 seconds can jump in air
             // Character 2: Magnet - 6 seconds double coins
             // Character 3: Dash - 5 seconds move faster (player runs ahead)
             if (headIndex == 0) {
-                abilityTimer = 5.0f;
-                std::cout << "Shield activated!" << std::endl;
+                abilityTimer = tuning.abilityDuration[0];
+                if (gameLogEnabled()) std::cout << "Shield activated!" << std::endl;
             } else if (headIndex == 1) {
-                abilityTimer = 8.0f;
+                abilityTimer = tuning.abilityDuration[1];
                 canDoubleJump = true;
-                std::cout << "Double Jump activated!" << std::endl;
+                if (gameLogEnabled()) std::cout << "Double Jump activated!" << std::endl;
             } else if (headIndex == 2) {
-                abilityTimer = 6.0f;
-                std::cout << "Magnet activated!" << std::endl;
+                abilityTimer = tuning.abilityDuration[2];
+                if (gameLogEnabled()) std::cout << "Magnet activated!" << std::endl;
             } else if (headIndex == 3) {
-                abilityTimer = 5.0f;
-                std::cout << "Dash activated!" << std::endl;
+                abilityTimer = tuning.abilityDuration[3];
+                if (gameLogEnabled()) std::cout << "Dash activated!" << std::endl;
             }
-            abilityCooldown = 8.0f; // 8 seconds cooldown for all
+            abilityCooldown = tuning.abilityCooldown; // the same cooldown for all (8 s)
         }
     }
     
@@ -192,7 +197,7 @@ public:
     }
     
     // Speed multiplier not used anymore (slow time removed)
-    float getSpeedMultiplier() {
+    float getSpeedMultiplier() const {
         return 1.0f;
     }
     
@@ -203,13 +208,13 @@ public:
     }
     
     // Check if character can double coin collection
-    bool hasDoubleCoinBonus() {
+    bool hasDoubleCoinBonus() const {
         // Character 2 (p3.PNG): Coin Magnet - collects double coins during ability
         return headIndex == 2 && abilityActive;
     }
     
     // Get player speed multiplier for dash ability
-    float getPlayerSpeedMultiplier() {
+    float getPlayerSpeedMultiplier() const {
         // Character 3 (P4.PNG): Dash - player moves faster (world moves slower relative to player)
         if (headIndex == 3 && abilityActive) {
             return 1.8f; // Game speed increases making player appear faster
@@ -0,0 +1,373 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/**
+ * FrameProfiler
+ * =============
+ *
+ * PURPOSE:
+ * Shows how a frame splits between input, simulation, rendering and the
+ * buffer swap, on the CPU and on the GPU.
+ *
+ * FEATURES:
+ * - Scoped CPU timers per frame phase (PROFILE_PHASE)
+ * - GL_TIME_ELAPSED queries around the render pass (PROFILE_GPU_BEGIN/END),
+ *   read back a few frames later so the CPU never waits on the GPU
+ * - Rolling window of the last FRAME_HISTORY frame times for p50/p99
+ * - Per-frame counters (ProfileCounter): draw calls, quads, glyphs, texture
+ *   and program binds, uniform uploads from Renderer2D::getStats(), live
+ *   entities from GameWorld::getStats(), heap allocations from AllocCounter
+ * - On-screen overlay through UIRenderer::renderProfilerOverlay (F3 toggles)
+ * - Counter averages and maxima printed on exit (printCounterSummary)
+ * - Optional dump on exit: METRO_PROFILE_OUT=<prefix> writes <prefix>.csv
+ *   (one row per frame, times and counters) and <prefix>_trace.json
+ *   (chrome://tracing events)
+ *
+ * BUILD:
+ * Only compiled with -DMETRO_PROFILE. Without it every PROFILE_* macro is
+ * empty and none of this code exists in the binary. Allocations are only
+ * counted with -DMETRO_COUNT_ALLOCS as well, which replaces the global
+ * operator new (see AllocCounter.h); otherwise they read as zero.
+ *
+ * USED BY:
+ * - Game class (main loop phases, overlay, dump in cleanup())
+ */
+
+#ifdef METRO_PROFILE
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "AllocCounter.h"
+
+enum ProfilePhase {
+    PHASE_INPUT,
+    PHASE_UPDATE,
+    PHASE_RENDER,
+    PHASE_SWAP,
+    PHASE_COUNT
+};
+
+inline const char* profilePhaseName(int phase) {
+    static const char* names[PHASE_COUNT] = {"input", "update", "render", "swap"};
+    return names[phase];
+}
+
+// Things counted per frame; Game sets all but COUNTER_ALLOCATIONS
+enum ProfileCounter {
+    COUNTER_DRAW_CALLS,
+    COUNTER_QUADS,
+    COUNTER_GLYPHS,
+    COUNTER_TEXTURE_BINDS,
+    COUNTER_PROGRAM_BINDS,
+    COUNTER_UNIFORM_UPLOADS,
+    COUNTER_ENTITIES,
+    COUNTER_ALLOCATIONS,
+    COUNTER_COUNT
+};
+
+inline const char* profileCounterName(int counter) {
+    static const char* names[COUNTER_COUNT] = {"draw_calls", "quads", "glyphs", "texture_binds",
+                                               "program_binds", "uniform_uploads", "entities",
+                                               "allocations"};
+    return names[counter];
+}
+
+class FrameProfiler {
+public:
+    static const int FRAME_HISTORY = 600;
+    static const int GPU_QUERY_RING = 4;
+    static const size_t MAX_RECORDED_FRAMES = 200000;
+
+    // One row of the CSV dump
+    struct FrameRecord {
+        float frameMs;
+        float phaseMs[PHASE_COUNT];
+        float gpuMs;
+        uint32_t counters[COUNTER_COUNT];
+    };
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct TraceEvent {
+        int phase;
+        double startUs;
+        double durationUs;
+    };
+
+    Clock::time_point epoch;
+    Clock::time_point lastFrameEnd;
+    bool haveLastFrame;
+
+    // Current frame
+    double phaseMs[PHASE_COUNT];
+    uint32_t counters[COUNTER_COUNT];
+
+    // Counters of the last finished frame, and over the whole run
+    uint32_t lastCounters[COUNTER_COUNT];
+    uint64_t counterSum[COUNTER_COUNT];
+    uint32_t counterMax[COUNTER_COUNT];
+    uint64_t countedFrames;
+    uint64_t allocationMark;          // AllocCounter at the end of the last frame
+    uint64_t ownAllocations;          // made by this profiler's own history, not the frame
+
+    // Rolling window
+    float frameHistory[FRAME_HISTORY];
+    int historyCount;
+    int historyNext;
+    float p50, p99;
+    float avgPhaseMs[PHASE_COUNT];
+    float gpuMs;
+
+    // GPU timer queries
+    unsigned int queries[GPU_QUERY_RING];
+    bool queryPending[GPU_QUERY_RING];
+    int queryWrite;
+    int queryRead;
+    bool queryActive;
+    bool gpuReady;
+
+    std::vector<FrameRecord> frames;
+    std::vector<TraceEvent> trace;
+
+    FrameProfiler() : haveLastFrame(false), countedFrames(0), allocationMark(0), ownAllocations(0),
+        historyCount(0), historyNext(0), p50(0), p99(0), gpuMs(0), queryWrite(0), queryRead(0),
+        queryActive(false), gpuReady(false) {
+        epoch = Clock::now();
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            phaseMs[i] = 0;
+            avgPhaseMs[i] = 0;
+        }
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            counters[i] = 0;
+            lastCounters[i] = 0;
+            counterSum[i] = 0;
+            counterMax[i] = 0;
+        }
+        for (int i = 0; i < GPU_QUERY_RING; i++) {
+            queries[i] = 0;
+            queryPending[i] = false;
+        }
+    }
+
+    double toUs(Clock::time_point t) const {
+        return std::chrono::duration<double, std::micro>(t - epoch).count();
+    }
+
+    // Collect finished GPU queries without blocking
+    void pollGpuQueries() {
+        while (queryPending[queryRead]) {
+            int available = 0;
+            glGetQueryObjectiv(queries[queryRead], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(queries[queryRead], GL_QUERY_RESULT, &ns);
+            gpuMs = (float)(ns / 1.0e6);
+            queryPending[queryRead] = false;
+            queryRead = (queryRead + 1) % GPU_QUERY_RING;
+        }
+    }
+
+    void updatePercentiles() {
+        std::vector<float> sorted(frameHistory, frameHistory + historyCount);
+        std::sort(sorted.begin(), sorted.end());
+        p50 = sorted[(sorted.size() - 1) * 50 / 100];
+        p99 = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+
+public:
+    static FrameProfiler& get() {
+        static FrameProfiler instance;
+        return instance;
+    }
+
+    // Needs a current GL context
+    void initGpu() {
+        glGenQueries(GPU_QUERY_RING, queries);
+        gpuReady = true;
+    }
+
+    void addPhaseTime(int phase, Clock::time_point start, Clock::time_point end) {
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        phaseMs[phase] += ms;
+        if (trace.size() < MAX_RECORDED_FRAMES * PHASE_COUNT) {
+            uint64_t before = AllocCounter::allocations().load(std::memory_order_relaxed);
+            trace.push_back(TraceEvent{phase, toUs(start), ms * 1000.0});
+            ownAllocations += AllocCounter::allocations().load(std::memory_order_relaxed) - before;
+        }
+    }
+
+    // Value of one counter for the current frame (last call wins)
+    void setCounter(int counter, uint32_t value) {
+        counters[counter] = value;
+    }
+
+    void gpuBegin() {
+        if (!gpuReady || queryActive) return;
+        // All queries still in flight: skip this frame rather than stall
+        if (queryPending[queryWrite]) return;
+        glBeginQuery(GL_TIME_ELAPSED, queries[queryWrite]);
+        queryActive = true;
+    }
+
+    void gpuEnd() {
+        if (!queryActive) return;
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryWrite] = true;
+        queryWrite = (queryWrite + 1) % GPU_QUERY_RING;
+        queryActive = false;
+    }
+
+    // Call once per presented frame, after the swap
+    void endFrame() {
+        Clock::time_point now = Clock::now();
+        if (gpuReady) pollGpuQueries();
+
+        uint64_t allocations = AllocCounter::allocations().load(std::memory_order_relaxed);
+        uint64_t frameAllocations = allocations - allocationMark - ownAllocations;
+        counters[COUNTER_ALLOCATIONS] = (uint32_t)std::min<uint64_t>(frameAllocations, UINT32_MAX);
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            lastCounters[i] = counters[i];
+        }
+
+        if (haveLastFrame) {
+            float frameMs = (float)std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+            frameHistory[historyNext] = frameMs;
+            historyNext = (historyNext + 1) % FRAME_HISTORY;
+            if (historyCount < FRAME_HISTORY) historyCount++;
+
+            // Percentiles and smoothed phases are refreshed a few times a second
+            const float smoothing = 0.05f;
+            for (int i = 0; i < PHASE_COUNT; i++) {
+                avgPhaseMs[i] += ((float)phaseMs[i] - avgPhaseMs[i]) * smoothing;
+            }
+            if (historyNext % 15 == 0) updatePercentiles();
+
+            // Skips the first frame, whose allocations are all of startup
+            for (int i = 0; i < COUNTER_COUNT; i++) {
+                counterSum[i] += counters[i];
+                counterMax[i] = std::max(counterMax[i], counters[i]);
+            }
+            countedFrames++;
+
+            if (frames.size() < MAX_RECORDED_FRAMES) {
+                FrameRecord rec;
+                rec.frameMs = frameMs;
+                for (int i = 0; i < PHASE_COUNT; i++) rec.phaseMs[i] = (float)phaseMs[i];
+                rec.gpuMs = gpuMs;
+                for (int i = 0; i < COUNTER_COUNT; i++) rec.counters[i] = counters[i];
+                frames.push_back(rec);
+            }
+        }
+
+        lastFrameEnd = now;
+        haveLastFrame = true;
+        for (int i = 0; i < PHASE_COUNT; i++) phaseMs[i] = 0;
+        for (int i = 0; i < COUNTER_COUNT; i++) counters[i] = 0;
+        ownAllocations = 0;
+        allocationMark = AllocCounter::allocations().load(std::memory_order_relaxed);
+    }
+
+    float getP50() const { return p50; }
+    float getP99() const { return p99; }
+    float getPhaseMs(int phase) const { return avgPhaseMs[phase]; }
+    float getGpuMs() const { return gpuMs; }
+    bool hasGpuTimes() const { return gpuReady; }
+    uint32_t getCounter(int counter) const { return lastCounters[counter]; }
+    bool countsAllocations() const { return AllocCounter::enabled(); }
+
+    // Average and maximum of every counter per frame, to stdout
+    void printCounterSummary() const {
+        if (countedFrames == 0) return;
+        std::cout << "Per frame over " << countedFrames << " frames (avg / max):" << std::endl;
+        for (int i = 0; i < COUNTER_COUNT; i++) {
+            std::cout << "  " << profileCounterName(i) << ": ";
+            if (i == COUNTER_ALLOCATIONS && !AllocCounter::enabled()) {
+                std::cout << "not counted (build with -DMETRO_COUNT_ALLOCS)" << std::endl;
+                continue;
+            }
+            std::cout << (double)counterSum[i] / countedFrames << " / " << counterMax[i] << std::endl;
+        }
+        if (AllocCounter::enabled()) {
+            std::cout << "  heap total: " << AllocCounter::allocations().load() << " allocations, "
+                      << AllocCounter::bytes().load() / 1024 << " KiB" << std::endl;
+        }
+    }
+
+    // Write the CSV and trace files if METRO_PROFILE_OUT is set
+    void dumpIfRequested() const {
+        const char* prefix = std::getenv("METRO_PROFILE_OUT");
+        if (!prefix || !*prefix) return;
+
+        std::string csvPath = std::string(prefix) + ".csv";
+        std::ofstream csv(csvPath);
+        if (csv.is_open()) {
+            csv << "frame,frame_ms";
+            for (int i = 0; i < PHASE_COUNT; i++) csv << "," << profilePhaseName(i) << "_ms";
+            csv << ",gpu_ms";
+            for (int i = 0; i < COUNTER_COUNT; i++) csv << "," << profileCounterName(i);
+            csv << "\n";
+            for (size_t f = 0; f < frames.size(); f++) {
+                csv << f << "," << frames[f].frameMs;
+                for (int i = 0; i < PHASE_COUNT; i++) csv << "," << frames[f].phaseMs[i];
+                csv << "," << frames[f].gpuMs;
+                for (int i = 0; i < COUNTER_COUNT; i++) csv << "," << frames[f].counters[i];
+                csv << "\n";
+            }
+            std::cout << "Profile written: " << csvPath << std::endl;
+        }
+
+        std::string tracePath = std::string(prefix) + "_trace.json";
+        std::ofstream json(tracePath);
+        if (json.is_open()) {
+            json << "{\"traceEvents\":[\n";
+            for (size_t i = 0; i < trace.size(); i++) {
+                json << "{\"name\":\"" << profilePhaseName(trace[i].phase)
+                     << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << (long long)trace[i].startUs
+                     << ",\"dur\":" << (long long)trace[i].durationUs << "}"
+                     << (i + 1 < trace.size() ? ",\n" : "\n");
+            }
+            json << "]}\n";
+            std::cout << "Trace written: " << tracePath << std::endl;
+        }
+    }
+};
+
+// RAII timer that adds its lifetime to one frame phase
+class ScopedPhaseTimer {
+private:
+    int phase;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit ScopedPhaseTimer(int p) : phase(p), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhaseTimer() {
+        FrameProfiler::get().addPhaseTime(phase, start, std::chrono::steady_clock::now());
+    }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_PHASE(phase) ScopedPhaseTimer PROFILE_CONCAT(profilePhase_, __LINE__)(phase)
+#define PROFILE_GPU_BEGIN() FrameProfiler::get().gpuBegin()
+#define PROFILE_GPU_END() FrameProfiler::get().gpuEnd()
+#define PROFILE_FRAME_END() FrameProfiler::get().endFrame()
+
+#else
+
+#define PROFILE_PHASE(phase)
+#define PROFILE_GPU_BEGIN()
+#define PROFILE_GPU_END()
+#define PROFILE_FRAME_END()
+
+#endif
+
+#endif
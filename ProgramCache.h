@@ -0,0 +1,219 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+/**
+ * ProgramCache
+ * ============
+ *
+ * PURPOSE:
+ * Skips GLSL compilation and linking on every launch after the first. A
+ * linked program's glGetProgramBinary output is stored under
+ * .shadercache/ and handed back to glProgramBinary next time.
+ *
+ * KEY:
+ * 64-bit FNV-1a over both shader sources plus GL_VENDOR, GL_RENDERER and
+ * GL_VERSION, so editing a shader or updating the driver picks a new file.
+ * The file repeats the key and the binary format; glProgramBinary also
+ * checks the blob itself and may reject it, in which case the program is
+ * compiled from source again and the file replaced.
+ *
+ * FILE FORMAT (native endianness, one file per program):
+ * - ProgramBinaryHeader: magic "MPRG", version, binary format, length, key
+ * - The driver's binary, 'length' bytes
+ *
+ * AVAILABILITY:
+ * glad is generated for GL 3.3 core, which has no program binaries
+ * (ARB_get_program_binary, core in 4.1). init() loads the entry points
+ * through the window system; without them, or with no binary formats, the
+ * cache is off and compileProgram() always builds from source.
+ *
+ * USED BY:
+ * - compileProgram() in Renderer2D.h (Renderer2D, WorldBuffer)
+ * - Game (init, summary)
+ *
+ * DEPENDENCIES:
+ * - GLAD; POSIX mkdir
+ */
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+// ARB_get_program_binary enums (not in the GL 3.3 glad header)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+struct ProgramBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t length;
+    uint64_t key;
+};
+
+static_assert(sizeof(ProgramBinaryHeader) == 24, "ProgramBinaryHeader layout is part of the file format");
+
+class ProgramCache {
+public:
+    static const uint32_t VERSION = 1;
+    static const uint32_t MAX_BINARY = 16u << 20;    // sanity limit for load()
+
+private:
+    typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+    typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+
+    GetProgramBinaryProc getProgramBinary;
+    ProgramBinaryProc programBinary;
+    ProgramParameteriProc programParameteri;
+    bool enabled;
+    std::string driver;       // vendor + renderer + version, part of every key
+
+    unsigned hits;
+    unsigned compiles;
+
+    ProgramCache() : getProgramBinary(nullptr), programBinary(nullptr), programParameteri(nullptr),
+        enabled(false), hits(0), compiles(0) {}
+
+    static uint64_t fnv1a(uint64_t hash, const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static std::string glString(GLenum name) {
+        const GLubyte* value = glGetString(name);
+        return value ? reinterpret_cast<const char*>(value) : "";
+    }
+
+    uint64_t key(const char* vsSource, const char* fsSource) const {
+        uint64_t hash = 14695981039346656037ULL;
+        hash = fnv1a(hash, vsSource, std::strlen(vsSource) + 1);
+        hash = fnv1a(hash, fsSource, std::strlen(fsSource) + 1);
+        return fnv1a(hash, driver.data(), driver.size());
+    }
+
+    static std::string path(uint64_t programKey) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.mprg", (unsigned long long)programKey);
+        return std::string(directory()) + "/" + name;
+    }
+
+public:
+    static ProgramCache& get() {
+        static ProgramCache instance;
+        return instance;
+    }
+
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    static const char* directory() { return ".shadercache"; }
+
+    // Needs a current GL context. 'load' resolves GL entry points
+    // (glfwGetProcAddress), the same loader glad was given.
+    void init(GLADloadproc load) {
+        getProgramBinary = (GetProgramBinaryProc)load("glGetProgramBinary");
+        programBinary = (ProgramBinaryProc)load("glProgramBinary");
+        programParameteri = (ProgramParameteriProc)load("glProgramParameteri");
+
+        GLint formats = 0;
+        if (getProgramBinary && programBinary && programParameteri) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        }
+        enabled = formats > 0;
+        driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+        if (!enabled) std::cout << "Shader cache: program binaries not supported, compiling from source" << std::endl;
+    }
+
+    // A linked program from the cache, or 0 on any miss
+    unsigned int load(const char* vsSource, const char* fsSource) {
+        if (!enabled) return 0;
+        uint64_t programKey = key(vsSource, fsSource);
+        FILE* file = std::fopen(path(programKey).c_str(), "rb");
+        if (!file) return 0;
+
+        ProgramBinaryHeader header;
+        std::vector<unsigned char> binary;
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                  std::memcmp(header.magic, "MPRG", 4) == 0 && header.version == VERSION &&
+                  header.key == programKey && header.length > 0 && header.length <= MAX_BINARY;
+        if (ok) {
+            binary.resize(header.length);
+            ok = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+        }
+        std::fclose(file);
+        if (!ok) return 0;
+
+        unsigned int program = glCreateProgram();
+        programBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            // Driver changed underneath the same strings; rebuild
+            glDeleteProgram(program);
+            return 0;
+        }
+        hits++;
+        return program;
+    }
+
+    // Before glLinkProgram on a program that store() will be called for
+    void prepareLink(unsigned int program) {
+        if (enabled) programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // After a successful link from source. Best effort, like TextureCache.
+    void store(unsigned int program, const char* vsSource, const char* fsSource) {
+        compiles++;
+        if (!enabled) return;
+        GLint linked = 0, length = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!linked || length <= 0 || (uint32_t)length > MAX_BINARY) return;
+
+        std::vector<unsigned char> binary((size_t)length);
+        GLenum format = 0;
+        GLsizei written = 0;
+        getProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) return;
+
+        ProgramBinaryHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "MPRG", 4);
+        header.version = VERSION;
+        header.format = format;
+        header.length = (uint32_t)written;
+        header.key = key(vsSource, fsSource);
+
+        mkdir(directory(), 0755);
+        std::string target = path(header.key);
+        std::string temp = target + ".tmp";
+        FILE* file = std::fopen(temp.c_str(), "wb");
+        if (!file) return;
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(binary.data(), 1, (size_t)written, file) == (size_t)written;
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(temp.c_str(), target.c_str()) != 0) {
+            std::remove(temp.c_str());
+        }
+    }
+
+    void printSummary() const {
+        std::cout << "Shader programs: " << hits << " from cache, " << compiles << " compiled" << std::endl;
+    }
+
+    bool isEnabled() const { return enabled; }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/**
+ * Random
+ * ======
+ *
+ * PURPOSE:
+ * Seedable per-session random numbers, so a run is fully determined by its
+ * seed and input stream (see InputRecording.h). Replaces the global rand().
+ *
+ * ALGORITHM:
+ * PCG32 (XSH RR variant): 64-bit state, 32-bit output, small and fast, and
+ * the same sequence on every platform for a given seed. splitmix64 derives
+ * independent session seeds from one base seed.
+ *
+ * USED BY:
+ * - GameWorld (obstacle types, coin heights)
+ * - Game / headless_sim (session seeds)
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+class Random {
+private:
+    uint64_t state;
+    static const uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static const uint64_t INCREMENT = 1442695040888963407ULL;
+
+public:
+    explicit Random(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        state = 0;
+        nextU32();
+        state += seed;
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        uint64_t old = state;
+        state = old * MULTIPLIER + INCREMENT;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // Uniform in [0, bound); bound must be > 0
+    uint32_t below(uint32_t bound) {
+        // Lemire's multiply-shift; the tiny bias is irrelevant here
+        return (uint32_t)(((uint64_t)nextU32() * bound) >> 32);
+    }
+
+    bool coinFlip() { return (nextU32() & 1) != 0; }
+
+    // splitmix64 step: a well-mixed seed for stream 'index' of 'base'
+    static uint64_t deriveSeed(uint64_t base, uint64_t index) {
+        uint64_t z = base + (index + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // A fresh seed for interactive play
+    static uint64_t entropySeed() {
+        std::random_device device;
+        uint64_t seed = ((uint64_t)device() << 32) ^ device();
+        uint64_t now = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+        return deriveSeed(seed, now);
+    }
+};
+
+#endif
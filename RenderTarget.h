@@ -0,0 +1,71 @@
+#pragma once
+#include <glad/glad.h>
+#include <iostream>
+#include "Texture.h"
+
+// Off-screen framebuffer with a single RGBA color texture. Anything drawn
+// between begin() and end() lands in getTexture(), which can then be drawn
+// like any other Texture (its V axis matches loaded images).
+class RenderTarget {
+private:
+    unsigned int fbo;
+    Texture colorTexture;
+    int width, height;
+    
+public:
+    RenderTarget() : fbo(0), width(0), height(0) {}
+    
+    // (Re)create the framebuffer; does nothing if the size is unchanged
+    bool create(int w, int h) {
+        if (fbo != 0 && w == width && h == height) return true;
+        release();
+        
+        width = w;
+        height = h;
+        colorTexture.createFromPixels(w, h, nullptr);
+        
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture.getID(), 0);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        
+        if (!complete) {
+            std::cerr << "ERROR: Framebuffer incomplete (" << w << "x" << h << ")" << std::endl;
+            release();
+            return false;
+        }
+        return true;
+    }
+    
+    void begin() const {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+    }
+    
+    // Return to the window framebuffer with its own viewport
+    void end(int windowWidth, int windowHeight) const {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, windowWidth, windowHeight);
+    }
+    
+    void release() {
+        if (fbo != 0) {
+            glDeleteFramebuffers(1, &fbo);
+            fbo = 0;
+        }
+        colorTexture.release();
+        width = height = 0;
+    }
+    
+    bool isValid() const { return fbo != 0; }
+    Texture* getTexture() { return &colorTexture; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    
+    ~RenderTarget() {
+        if (fbo != 0) {
+            glDeleteFramebuffers(1, &fbo);
+        }
+    }
+};
@@ -3,11 +3,14 @@
 
 #include <glad/glad.h>
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
 #include <iostream>
 #include "Texture.h"
-
-const int SCREEN_WIDTH = 1200;
-const int SCREEN_HEIGHT = 800;
+#include "TextureAtlas.h"
+#include "GameConfig.h"
+#include "ProgramCache.h"
 
 // helper: print shader compile/link errors
 static void checkShaderCompile(unsigned int shader, const char* name) {
@@ -29,134 +32,437 @@ static void checkProgramLink(unsigned int prog) {
     }
 }
 
+// Compile and link a vertex + fragment shader pair (errors go to stderr).
+// Goes through ProgramCache, so later launches usually skip both steps.
+inline unsigned int compileProgram(const char* vsSource, const char* fsSource) {
+    ProgramCache& cache = ProgramCache::get();
+    unsigned int cached = cache.load(vsSource, fsSource);
+    if (cached != 0) return cached;
+    
+    unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, &vsSource, NULL);
+    glCompileShader(vertex);
+    checkShaderCompile(vertex, "vertex");
+    
+    unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, &fsSource, NULL);
+    glCompileShader(fragment);
+    checkShaderCompile(fragment, "fragment");
+    
+    unsigned int prog = glCreateProgram();
+    glAttachShader(prog, vertex);
+    glAttachShader(prog, fragment);
+    cache.prepareLink(prog);
+    glLinkProgram(prog);
+    checkProgramLink(prog);
+    cache.store(prog, vsSource, fsSource);
+    
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    return prog;
+}
+
+// Vertex layout of the sprite batch. Positions are already in NDC so a whole
+// batch shares one program state; texMix selects flat color (0), texture (1)
+// or texture sampled at texel centers (2, pixel font), so untextured quads
+// never break a run of textured ones and the font can share a linear atlas.
+struct BatchVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+    float texMix;
+};
+
+// One quad as stored by the batch, already converted to NDC
+struct BatchQuad {
+    const Texture* tex;
+    BatchVertex v[4];
+};
+
+// Recorded quads that can be replayed into a batch without regenerating them
+// (see Renderer2D::beginCapture / drawQuadList)
+typedef std::vector<BatchQuad> QuadList;
+
+// How a batch orders its quads at flush time.
+// SUBMISSION keeps painter's order and merges neighbouring quads that share a
+// texture. TEXTURE stable-sorts by texture first, which gives the fewest draws
+// but is only correct when the caller's quads don't overlap.
+enum class BatchSortMode {
+    SUBMISSION,
+    TEXTURE
+};
+
+// What reached GL since the last RenderStats::reset(). Binds and uniform
+// uploads count real GL calls, not the ones GLStateCache filtered out.
+// Code drawing past the renderer (WorldBuffer) adds its own calls here.
+struct RenderStats {
+    unsigned drawCalls = 0;
+    unsigned quads = 0;            // quads drawn, glyphs included
+    unsigned glyphs = 0;           // characters laid out (replayed QuadLists count as quads only)
+    unsigned textureBinds = 0;
+    unsigned programBinds = 0;
+    unsigned uniformUploads = 0;
+    
+    void reset() { *this = RenderStats(); }
+};
+
+// Tracks what is bound so Renderer2D only talks to GL when something changes.
+// Anything outside the renderer that binds GL objects (Texture::load etc.)
+// makes this stale, so it is invalidated whenever a new batch begins.
+struct GLStateCache {
+    unsigned int program = 0;
+    unsigned int vao = 0;
+    unsigned int arrayBuffer = 0;
+    unsigned int texture = 0;
+    bool valid = false;
+    RenderStats* stats = nullptr;
+    
+    void invalidate() { valid = false; }
+    
+    void useProgram(unsigned int id) {
+        if (valid && program == id) return;
+        validate();
+        glUseProgram(id);
+        program = id;
+        if (stats) stats->programBinds++;
+    }
+    
+    void bindVertexArray(unsigned int id) {
+        if (valid && vao == id) return;
+        validate();
+        glBindVertexArray(id);
+        vao = id;
+    }
+    
+    void bindArrayBuffer(unsigned int id) {
+        if (valid && arrayBuffer == id) return;
+        validate();
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        arrayBuffer = id;
+    }
+    
+    void bindTexture(unsigned int id) {
+        if (valid && texture == id) return;
+        validate();
+        glBindTexture(GL_TEXTURE_2D, id);
+        texture = id;
+        if (stats) stats->textureBinds++;
+    }
+    
+private:
+    // First call after invalidate(): assume nothing is bound and force every bind
+    void validate() {
+        if (valid) return;
+        valid = true;
+        glActiveTexture(GL_TEXTURE0);
+        program = vao = arrayBuffer = texture = ~0u;
+    }
+};
+
 // Simple 2D Renderer for textured quads
 class Renderer2D {
 private:
-    unsigned int VAO = 0, VBO = 0, EBO = 0;
-    unsigned int shaderProgram = 0;
+    // Sprite batch state
+    static const int MAX_BATCH_QUADS = 4096;
+    unsigned int batchVAO = 0, batchVBO = 0, batchEBO = 0;
+    unsigned int batchProgram = 0;
+    bool batching = false;
+    BatchSortMode sortMode = BatchSortMode::SUBMISSION;
+    std::vector<BatchQuad> batchQuads;
+    QuadList* capture = nullptr;       // when set, quads are recorded instead of drawn
+    std::vector<BatchVertex> batchVertices;
+    int batchWriteQuad = 0;   // next free quad slot in the streaming VBO
+    
+    // Uniform locations, resolved once after linking
+    struct BatchUniforms {
+        int texture1 = -1;
+    } uniforms;
+    GLStateCache state;
+    RenderStats stats;
+    
+    // Font atlas: printable ASCII from ' ' to '_' baked into 8x8 texel cells
+    static const int FONT_FIRST_CHAR = 32;
+    static const int FONT_GLYPH_COUNT = 64;
+    static const int FONT_CELL = 8;
+    static const int FONT_ATLAS_COLS = 16;
+    static const int FONT_ATLAS_WIDTH = FONT_ATLAS_COLS * FONT_CELL;
+    static const int FONT_ATLAS_HEIGHT = (FONT_GLYPH_COUNT / FONT_ATLAS_COLS) * FONT_CELL;
+    Texture fontAtlas;
+    SpriteRegion fontRegion;                  // fontAtlas, or its copy in a shared atlas page
+    bool glyphHasPixels[FONT_GLYPH_COUNT] = {};
+    std::vector<unsigned char> glyphPixels;   // RGBA, kept for packing into an atlas
+    int bakeGlyph = 0;
     
-    const char* vertexShaderSource = R"(
+    const char* batchVertexShaderSource = R"(
         #version 330 core
         layout (location = 0) in vec2 aPos;
         layout (location = 1) in vec2 aTexCoord;
+        layout (location = 2) in vec4 aColor;
+        layout (location = 3) in float aTexMix;
         out vec2 TexCoord;
-        uniform mat4 transform;
+        out vec4 Color;
+        out float TexMix;
         void main() {
-            gl_Position = transform * vec4(aPos, 0.0, 1.0);
+            gl_Position = vec4(aPos, 0.0, 1.0);
             TexCoord = aTexCoord;
+            Color = aColor;
+            TexMix = aTexMix;
         }
     )";
     
-    const char* fragmentShaderSource = R"(
+    const char* batchFragmentShaderSource = R"(
         #version 330 core
         in vec2 TexCoord;
+        in vec4 Color;
+        in float TexMix;
         out vec4 FragColor;
         uniform sampler2D texture1;
-        uniform vec4 color;
-        uniform bool useTexture;
         void main() {
-            if (useTexture) {
-                vec4 t = texture(texture1, TexCoord);
-                FragColor = t * color;
-            } else {
-                FragColor = color;
+            vec2 uv = TexCoord;
+            if (TexMix > 1.5) {
+                vec2 size = vec2(textureSize(texture1, 0));
+                uv = (floor(uv * size) + 0.5) / size;
             }
+            vec4 t = texture(texture1, uv);
+            FragColor = mix(Color, t * Color, min(TexMix, 1.0));
         }
     )";
     
-public:
-    Renderer2D() {
-        // Setup quad vertices (-0.5..0.5 centered) and tex coords
-        float vertices[] = {
-            // positions        // tex coords (flipped V so images appear right-side up)
-            -0.5f, -0.5f,       0.0f, 1.0f,
-             0.5f, -0.5f,       1.0f, 1.0f,
-             0.5f,  0.5f,       1.0f, 0.0f,
-            -0.5f,  0.5f,       0.0f, 0.0f
-        };
-        unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+    void initBatch() {
+        batchProgram = compileProgram(batchVertexShaderSource, batchFragmentShaderSource);
+        
+        // Static index buffer: quad i uses vertices 4i..4i+3
+        std::vector<unsigned int> indices(MAX_BATCH_QUADS * 6);
+        for (int i = 0; i < MAX_BATCH_QUADS; i++) {
+            unsigned int base = i * 4;
+            indices[i*6 + 0] = base + 0;
+            indices[i*6 + 1] = base + 1;
+            indices[i*6 + 2] = base + 2;
+            indices[i*6 + 3] = base + 2;
+            indices[i*6 + 4] = base + 3;
+            indices[i*6 + 5] = base + 0;
+        }
         
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+        glGenVertexArrays(1, &batchVAO);
+        glGenBuffers(1, &batchVBO);
+        glGenBuffers(1, &batchEBO);
         
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glBindVertexArray(batchVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, batchVBO);
+        glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_QUADS * 4 * sizeof(BatchVertex), NULL, GL_STREAM_DRAW);
         
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batchEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
         
-        // position
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+        GLsizei stride = sizeof(BatchVertex);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, x));
         glEnableVertexAttribArray(0);
-        // texcoord
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, u));
         glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, r));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, texMix));
+        glEnableVertexAttribArray(3);
+        glBindVertexArray(0);
         
-        // Create shader
-        unsigned int vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vertexShaderSource, NULL);
-        glCompileShader(vertex);
-        checkShaderCompile(vertex, "vertex");
+        uniforms.texture1 = glGetUniformLocation(batchProgram, "texture1");
+        glUseProgram(batchProgram);
+        glUniform1i(uniforms.texture1, 0);
+        glUseProgram(0);
+        stats.programBinds++;
+        stats.uniformUploads++;
         
-        unsigned int fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fragmentShaderSource, NULL);
-        glCompileShader(fragment);
-        checkShaderCompile(fragment, "fragment");
+        batchQuads.reserve(MAX_BATCH_QUADS);
+        batchVertices.reserve(MAX_BATCH_QUADS * 4);
+    }
+    
+    // Append one quad to the batch, converting the screen rect to NDC.
+    // UVs default to the whole texture with V flipped like the immediate quad.
+    void submitQuad(float x, float y, float width, float height,
+                    const Texture* tex, float r, float g, float b, float a,
+                    float u0 = 0.0f, float vTop = 1.0f, float u1 = 1.0f, float vBottom = 0.0f,
+                    bool pixelSnap = false) {
+        if (!capture && (int)batchQuads.size() >= MAX_BATCH_QUADS) {
+            flush();
+        }
         
-        shaderProgram = glCreateProgram();
-        glAttachShader(shaderProgram, vertex);
-        glAttachShader(shaderProgram, fragment);
-        glLinkProgram(shaderProgram);
-        checkProgramLink(shaderProgram);
+        float x0 = (x * 2.0f) / float(SCREEN_WIDTH) - 1.0f;
+        float x1 = ((x + width) * 2.0f) / float(SCREEN_WIDTH) - 1.0f;
+        float y0 = 1.0f - (y * 2.0f) / float(SCREEN_HEIGHT);
+        float y1 = 1.0f - ((y + height) * 2.0f) / float(SCREEN_HEIGHT);
+        float mixValue = tex ? (pixelSnap ? 2.0f : 1.0f) : 0.0f;
         
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        // Same winding as the immediate-mode quad
+        BatchQuad q;
+        q.tex = tex;
+        q.v[0] = {x0, y0, u0, vTop, r, g, b, a, mixValue};
+        q.v[1] = {x1, y0, u1, vTop, r, g, b, a, mixValue};
+        q.v[2] = {x1, y1, u1, vBottom, r, g, b, a, mixValue};
+        q.v[3] = {x0, y1, u0, vBottom, r, g, b, a, mixValue};
+        if (capture) capture->push_back(q);
+        else batchQuads.push_back(q);
     }
     
-    void drawQuad(float x, float y, float width, float height, 
-                  Texture* tex = nullptr, float r = 1, float g = 1, float b = 1, float a = 1) {
-        glUseProgram(shaderProgram);
+    // Capture target for rasterizeChar while baking the atlas. Rows are
+    // written bottom-up so the atlas has the same orientation as loaded images.
+    void plotGlyphPixel(float x, float y) {
+        int px = (int)(x + 0.5f);
+        int py = (int)(y + 0.5f);
+        if (px < 0 || px >= FONT_CELL || py < 0 || py >= FONT_CELL) return;
+        
+        int col = bakeGlyph % FONT_ATLAS_COLS;
+        int row = bakeGlyph / FONT_ATLAS_COLS;
+        int texX = col * FONT_CELL + px;
+        int texY = FONT_ATLAS_HEIGHT - 1 - (row * FONT_CELL + py);
+        unsigned char* texel = &glyphPixels[(texY * FONT_ATLAS_WIDTH + texX) * 4];
+        texel[0] = texel[1] = texel[2] = texel[3] = 255;
+        glyphHasPixels[bakeGlyph] = true;
+    }
+    
+    // Bake every glyph pattern once into a white-on-transparent atlas, so the
+    // existing shader tints it with the text color
+    void initFontAtlas() {
+        glyphPixels.assign(FONT_ATLAS_WIDTH * FONT_ATLAS_HEIGHT * 4, 0);
+        for (bakeGlyph = 0; bakeGlyph < FONT_GLYPH_COUNT; bakeGlyph++) {
+            rasterizeChar((char)(FONT_FIRST_CHAR + bakeGlyph), 0, 0, 7.0f);
+        }
+        fontAtlas.createFromPixels(FONT_ATLAS_WIDTH, FONT_ATLAS_HEIGHT, glyphPixels.data(), true);
+        fontRegion = SpriteRegion::whole(&fontAtlas);
+    }
+    
+    void drawBatchRun(const Texture* tex, size_t first, size_t last, int baseQuad) {
+        if (last <= first) return;
+        if (tex) state.bindTexture(tex->getID());
+        glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)((last - first) * 6), GL_UNSIGNED_INT,
+                                 (void*)(first * 6 * sizeof(unsigned int)), baseQuad * 4);
+        stats.drawCalls++;
+    }
+    
+public:
+    Renderer2D() {
+        state.stats = &stats;
+        initBatch();
+        initFontAtlas();
+    }
+    
+    // Start collecting quads. Every drawQuad/drawText until endBatch() is
+    // buffered and sent in as few draw calls as possible.
+    void beginBatch(BatchSortMode mode = BatchSortMode::SUBMISSION) {
+        if (batching) flush();
+        else state.invalidate();
+        batching = true;
+        sortMode = mode;
+    }
+    
+    void endBatch() {
+        flush();
+        batching = false;
+    }
+    
+    bool isBatching() const { return batching; }
+    
+    // Record every quad drawn until endCapture() into 'out' instead of
+    // drawing it. Replay the result each frame with drawQuadList().
+    void beginCapture(QuadList& out) {
+        out.clear();
+        capture = &out;
+    }
+    
+    void endCapture() {
+        capture = nullptr;
+    }
+    
+    // Append previously captured quads to the current batch
+    void drawQuadList(const QuadList& list) {
+        for (const auto& q : list) {
+            if ((int)batchQuads.size() >= MAX_BATCH_QUADS) flush();
+            batchQuads.push_back(q);
+        }
+        if (!batching) flush();
+    }
+    
+    // Call after binding GL objects behind the renderer's back
+    void invalidateState() { state.invalidate(); }
+    
+    // Counters since the last resetStats(), usually one frame
+    const RenderStats& getStats() const { return stats; }
+    RenderStats& getStats() { return stats; }
+    void resetStats() { stats.reset(); }
+    
+    // Upload all pending quads and draw them, one draw per texture run
+    void flush() {
+        if (batchQuads.empty()) return;
         
-        // Transform: scale to pixel size, then translate to screen position
-        // We use a column-major matrix for OpenGL
-        // Scale: (width, height) in pixels → NDC scale
-        // Translate: (x, y) top-left in pixels → NDC position
-        // Y is flipped: y=0 at top, y=SCREEN_HEIGHT at bottom
-        // NDC: x=-1..1, y=-1(bottom)..1(top)
-        // translate_x = -1 + ( (x + width/2) * 2 / SCREEN_WIDTH )
-        // translate_y = 1 - ( (y + height/2) * 2 / SCREEN_HEIGHT )
-        float sx = (width * 2.0f) / float(SCREEN_WIDTH);
-        float sy = -(height * 2.0f) / float(SCREEN_HEIGHT); // flip Y
-        float tx = ((x + width * 0.5f) * 2.0f) / float(SCREEN_WIDTH) - 1.0f;
-        float ty = 1.0f - ((y + height * 0.5f) * 2.0f) / float(SCREEN_HEIGHT);
+        if (batching && sortMode == BatchSortMode::TEXTURE) {
+            std::stable_sort(batchQuads.begin(), batchQuads.end(),
+                [](const BatchQuad& a, const BatchQuad& b) { return a.tex < b.tex; });
+        }
         
-        // Column-major matrix for OpenGL:
-        float transform[16] = {
-            sx, 0.0f, 0.0f, 0.0f,
-            0.0f, sy, 0.0f, 0.0f,
-            0.0f, 0.0f, 1.0f, 0.0f,
-            tx,  ty,  0.0f, 1.0f
-        };
+        batchVertices.clear();
+        for (const auto& q : batchQuads) {
+            batchVertices.insert(batchVertices.end(), q.v, q.v + 4);
+        }
+        
+        // Append after the previous flush's data and only orphan the storage
+        // once it is full, so small flushes don't reallocate every time
+        int quadCount = (int)batchQuads.size();
+        if (batchWriteQuad + quadCount > MAX_BATCH_QUADS) {
+            state.bindArrayBuffer(batchVBO);
+            glBufferData(GL_ARRAY_BUFFER, MAX_BATCH_QUADS * 4 * sizeof(BatchVertex), NULL, GL_STREAM_DRAW);
+            batchWriteQuad = 0;
+        }
+        int baseQuad = batchWriteQuad;
+        batchWriteQuad += quadCount;
+        stats.quads += quadCount;
         
-        int tloc = glGetUniformLocation(shaderProgram, "transform");
-        if (tloc >= 0) glUniformMatrix4fv(tloc, 1, GL_FALSE, transform);
-        int cloc = glGetUniformLocation(shaderProgram, "color");
-        if (cloc >= 0) glUniform4f(cloc, r, g, b, a);
+        state.useProgram(batchProgram);
+        state.bindVertexArray(batchVAO);
+        state.bindArrayBuffer(batchVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, baseQuad * 4 * sizeof(BatchVertex),
+                        batchVertices.size() * sizeof(BatchVertex), batchVertices.data());
         
-        if (tex) {
-            glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 1);
-            glActiveTexture(GL_TEXTURE0);
-            tex->bind();
-        } else {
-            glUniform1i(glGetUniformLocation(shaderProgram, "useTexture"), 0);
+        // Walk the quads and cut a new draw only when a textured quad needs a
+        // different texture than the current run. Flat-colored quads join any run.
+        size_t runStart = 0;
+        const Texture* runTex = nullptr;
+        for (size_t i = 0; i < batchQuads.size(); i++) {
+            const Texture* tex = batchQuads[i].tex;
+            if (!tex || tex == runTex) continue;
+            if (runTex && i > runStart) {
+                drawBatchRun(runTex, runStart, i, baseQuad);
+                runStart = i;
+            }
+            runTex = tex;
         }
+        drawBatchRun(runTex, runStart, batchQuads.size(), baseQuad);
         
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        glUseProgram(0);
+        batchQuads.clear();
+    }
+    
+    void drawQuad(float x, float y, float width, float height, 
+                  Texture* tex = nullptr, float r = 1, float g = 1, float b = 1, float a = 1) {
+        submitQuad(x, y, width, height, tex, r, g, b, a);
+        
+        // Outside a batch, draw right away through the same vertex path
+        if (!batching && !capture) flush();
+    }
+    
+    // Draw part of a texture, typically a sprite in an atlas page
+    void drawQuad(float x, float y, float width, float height, const SpriteRegion& sprite,
+                  float r = 1, float g = 1, float b = 1, float a = 1) {
+        submitQuad(x, y, width, height, sprite.texture, r, g, b, a,
+                   sprite.u0, sprite.v1, sprite.u1, sprite.v0);
+        if (!batching && !capture) flush();
+    }
+    
+    // Font glyph bitmap (RGBA, bottom row first) for packing into an atlas
+    const unsigned char* getFontPixels() const { return glyphPixels.data(); }
+    int getFontAtlasWidth() const { return FONT_ATLAS_WIDTH; }
+    int getFontAtlasHeight() const { return FONT_ATLAS_HEIGHT; }
+    
+    // Draw text from a copy of the font bitmap in a shared atlas page
+    void setFontRegion(const SpriteRegion& region) {
+        if (region.isValid()) fontRegion = region;
     }
     
     // Draw a pixel for bitmap font
@@ -164,351 +470,400 @@ public:
         drawQuad(x, y, pixelSize, pixelSize, nullptr, r, g, b, 1.0f);
     }
     
-    // Draw a character using bitmap patterns
+    // Draw a character as one textured quad cut from the font atlas
     void drawChar(char c, float x, float y, float size, float r, float g, float b) {
+        int glyph = (unsigned char)c - FONT_FIRST_CHAR;
+        if (glyph < 0 || glyph >= FONT_GLYPH_COUNT || !glyphHasPixels[glyph]) return;
+        
+        bool ownBatch = !batching && !capture;
+        if (ownBatch) beginBatch();
+        
+        float pixelSize = size / 7.0f;
+        float cellSize = FONT_CELL * pixelSize;
+        int col = glyph % FONT_ATLAS_COLS;
+        int row = glyph / FONT_ATLAS_COLS;
+        float u0 = float(col * FONT_CELL) / FONT_ATLAS_WIDTH;
+        float u1 = float(col * FONT_CELL + FONT_CELL) / FONT_ATLAS_WIDTH;
+        float vTop = 1.0f - float(row * FONT_CELL) / FONT_ATLAS_HEIGHT;
+        float vBottom = 1.0f - float(row * FONT_CELL + FONT_CELL) / FONT_ATLAS_HEIGHT;
+        
+        // Map the cell into wherever the font bitmap lives
+        float du = fontRegion.u1 - fontRegion.u0;
+        float dv = fontRegion.v1 - fontRegion.v0;
+        submitQuad(x, y, cellSize, cellSize, fontRegion.texture, r, g, b, 1.0f,
+                   fontRegion.u0 + u0 * du, fontRegion.v0 + vTop * dv,
+                   fontRegion.u0 + u1 * du, fontRegion.v0 + vBottom * dv, true);
+        if (!capture) stats.glyphs++;
+        
+        if (ownBatch) endBatch();
+    }
+    
+private:
+    // Hand-coded 5x7 glyph patterns. Only run once at startup to bake the
+    // font atlas; each "pixel" lands in the glyph bitmap via plotGlyphPixel.
+    void rasterizeChar(char c, float x, float y, float size) {
         float pixelSize = size / 7.0f;
         
         // 5x7 bitmap font patterns
         if (c == 'A') {
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 4*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y);
+            plotGlyphPixel(x, y + pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + pixelSize);
+            plotGlyphPixel(x, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x, y + 3*pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x, y + 4*pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x, y + 5*pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x, y + 6*pixelSize);
+            plotGlyphPixel(x + 4*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'B') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'C') {
-            for (int i = 1; i < 6; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 1; i < 6; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'D') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'E') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
             for (int i = 0; i < 4; i++) {
-                drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+                plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
         }
         else if (c == 'F') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
             for (int i = 0; i < 4; i++) {
-                drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
             }
         }
         else if (c == 'G') {
-            for (int i = 1; i < 6; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
+            for (int i = 1; i < 6; i++) plotGlyphPixel(x, y + i*pixelSize);
             for (int i = 1; i < 4; i++) {
-                drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
-            drawPixel(x + 3*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + 3*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
         }
         else if (c == 'H') {
             for (int i = 0; i < 7; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
         }
         else if (c == 'I') {
-            for (int i = 0; i < 7; i++) drawPixel(x + pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x + pixelSize, y + i*pixelSize);
             for (int i = 0; i < 3; i++) {
-                drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
         }
         else if (c == 'J') {
-            for (int i = 0; i < 7; i++) drawPixel(x + 2*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x + 2*pixelSize, y + i*pixelSize);
+            plotGlyphPixel(x, y + 5*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
         }
         else if (c == 'K') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'L') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            for (int i = 1; i < 4; i++) drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            for (int i = 1; i < 4; i++) plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'M') {
             for (int i = 0; i < 7; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 4*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 4*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
         }
         else if (c == 'N') {
             for (int i = 0; i < 7; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 4*pixelSize);
         }
         else if (c == 'O') {
             for (int i = 1; i < 6; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'P') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
         }
         else if (c == 'Q') {
             for (int i = 1; i < 6; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'R') {
-            for (int i = 0; i < 7; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x, y + i*pixelSize);
+            plotGlyphPixel(x + pixelSize, y);
+            plotGlyphPixel(x + 2*pixelSize, y);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'S') {
-            for (int i = 1; i < 4; i++) drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            for (int i = 0; i < 3; i++) drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            for (int i = 1; i < 4; i++) plotGlyphPixel(x + i*pixelSize, y);
+            plotGlyphPixel(x, y + pixelSize);
+            plotGlyphPixel(x, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+            for (int i = 0; i < 3; i++) plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'T') {
-            for (int i = 0; i < 5; i++) drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-            for (int i = 1; i < 7; i++) drawPixel(x + 2*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+            for (int i = 0; i < 5; i++) plotGlyphPixel(x + i*pixelSize, y);
+            for (int i = 1; i < 7; i++) plotGlyphPixel(x + 2*pixelSize, y + i*pixelSize);
         }
         else if (c == 'U') {
             for (int i = 0; i < 6; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'V') {
             for (int i = 0; i < 5; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
         }
         else if (c == 'W') {
             for (int i = 0; i < 7; i++) {
-                drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 4*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + 4*pixelSize, y + i*pixelSize);
             }
-            drawPixel(x + pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
         }
         else if (c == 'X') {
-            drawPixel(x, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 6*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x, y);
+            plotGlyphPixel(x + 3*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 5*pixelSize);
+            plotGlyphPixel(x, y + 6*pixelSize);
+            plotGlyphPixel(x + 3*pixelSize, y + 6*pixelSize);
         }
         else if (c == 'Y') {
-            drawPixel(x, y, pixelSize, r, g, b);
-            drawPixel(x + 3*pixelSize, y, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            for (int i = 2; i < 7; i++) drawPixel(x + pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x, y);
+            plotGlyphPixel(x + 3*pixelSize, y);
+            plotGlyphPixel(x + pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + pixelSize);
+            for (int i = 2; i < 7; i++) plotGlyphPixel(x + pixelSize, y + i*pixelSize);
         }
         else if (c == 'Z') {
             for (int i = 0; i < 4; i++) {
-                drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
-            drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-            drawPixel(x + 2*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-            drawPixel(x + pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-            drawPixel(x, y + 5*pixelSize, pixelSize, r, g, b);
+            plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+            plotGlyphPixel(x + 2*pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 4*pixelSize);
+            plotGlyphPixel(x, y + 5*pixelSize);
+        }
+        // Punctuation for numeric readouts (debug overlays)
+        else if (c == '.') {
+            plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+        }
+        else if (c == ':') {
+            plotGlyphPixel(x + pixelSize, y + 2*pixelSize);
+            plotGlyphPixel(x + pixelSize, y + 5*pixelSize);
+        }
+        else if (c == '-') {
+            for (int i = 0; i < 3; i++) plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+        }
+        else if (c == '/') {
+            for (int i = 0; i < 7; i++) plotGlyphPixel(x + (3 - (i * 4) / 7)*pixelSize, y + i*pixelSize);
         }
         else if (c >= '0' && c <= '9') {
             int digit = c - '0';
             // Numbers 0-9 patterns
             if (digit == 0) {
                 for (int i = 1; i < 6; i++) {
-                    drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                    drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                    plotGlyphPixel(x, y + i*pixelSize);
+                    plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
                 }
-                drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + pixelSize, y);
+                plotGlyphPixel(x + 2*pixelSize, y);
+                plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+                plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
             }
             else if (digit == 1) {
-                for (int i = 0; i < 7; i++) drawPixel(x + pixelSize, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x, y + pixelSize, pixelSize, r, g, b);
+                for (int i = 0; i < 7; i++) plotGlyphPixel(x + pixelSize, y + i*pixelSize);
+                plotGlyphPixel(x, y + pixelSize);
             }
             else if (digit == 2) {
-                drawPixel(x, y, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-                drawPixel(x, y + 5*pixelSize, pixelSize, r, g, b);
-                for (int i = 0; i < 4; i++) drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x, y);
+                plotGlyphPixel(x + pixelSize, y);
+                plotGlyphPixel(x + 2*pixelSize, y);
+                plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+                plotGlyphPixel(x + 2*pixelSize, y + 3*pixelSize);
+                plotGlyphPixel(x + pixelSize, y + 4*pixelSize);
+                plotGlyphPixel(x, y + 5*pixelSize);
+                for (int i = 0; i < 4; i++) plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
             else if (digit == 3) {
                 for (int i = 0; i < 4; i++) {
-                    drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                    plotGlyphPixel(x + i*pixelSize, y);
+                    plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+                    plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
                 }
-                drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
+                plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 2*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
             }
             else if (digit == 4) {
-                for (int i = 0; i < 4; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                for (int i = 0; i < 7; i++) drawPixel(x + 2*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
+                for (int i = 0; i < 4; i++) plotGlyphPixel(x, y + i*pixelSize);
+                for (int i = 0; i < 7; i++) plotGlyphPixel(x + 2*pixelSize, y + i*pixelSize);
+                plotGlyphPixel(x + pixelSize, y + 3*pixelSize);
             }
             else if (digit == 5) {
-                for (int i = 0; i < 4; i++) drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x, y + pixelSize, pixelSize, r, g, b);
-                drawPixel(x, y + 2*pixelSize, pixelSize, r, g, b);
-                for (int i = 0; i < 3; i++) drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-                for (int i = 0; i < 3; i++) drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                for (int i = 0; i < 4; i++) plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x, y + pixelSize);
+                plotGlyphPixel(x, y + 2*pixelSize);
+                for (int i = 0; i < 3; i++) plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+                for (int i = 0; i < 3; i++) plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
             }
             else if (digit == 6) {
-                for (int i = 1; i < 6; i++) drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y, pixelSize, r, g, b);
-                for (int i = 0; i < 3; i++) drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 4*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + 5*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                for (int i = 1; i < 6; i++) plotGlyphPixel(x, y + i*pixelSize);
+                plotGlyphPixel(x + pixelSize, y);
+                plotGlyphPixel(x + 2*pixelSize, y);
+                for (int i = 0; i < 3; i++) plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 4*pixelSize);
+                plotGlyphPixel(x + 3*pixelSize, y + 5*pixelSize);
+                plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+                plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
             }
             else if (digit == 7) {
-                for (int i = 0; i < 4; i++) drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                drawPixel(x + 3*pixelSize, y + pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y + 2*pixelSize, pixelSize, r, g, b);
-                for (int i = 3; i < 7; i++) drawPixel(x + pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                for (int i = 0; i < 4; i++) plotGlyphPixel(x + i*pixelSize, y);
+                plotGlyphPixel(x + 3*pixelSize, y + pixelSize);
+                plotGlyphPixel(x + 2*pixelSize, y + 2*pixelSize);
+                for (int i = 3; i < 7; i++) plotGlyphPixel(x + pixelSize, y + i*pixelSize);
             }
             else if (digit == 8) {
                 for (int i = 1; i < 6; i++) {
-                    drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                    drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
+                    plotGlyphPixel(x, y + i*pixelSize);
+                    plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
                 }
                 for (int i = 1; i < 3; i++) {
-                    drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                    plotGlyphPixel(x + i*pixelSize, y);
+                    plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
+                    plotGlyphPixel(x + i*pixelSize, y + 6*pixelSize);
                 }
             }
             else if (digit == 9) {
                 for (int i = 1; i < 4; i++) {
-                    drawPixel(x, y + i*pixelSize, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y, pixelSize, r, g, b);
-                    drawPixel(x + i*pixelSize, y + 3*pixelSize, pixelSize, r, g, b);
+                    plotGlyphPixel(x, y + i*pixelSize);
+                    plotGlyphPixel(x + i*pixelSize, y);
+                    plotGlyphPixel(x + i*pixelSize, y + 3*pixelSize);
                 }
-                for (int i = 1; i < 6; i++) drawPixel(x + 3*pixelSize, y + i*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
-                drawPixel(x + 2*pixelSize, y + 6*pixelSize, pixelSize, r, g, b);
+                for (int i = 1; i < 6; i++) plotGlyphPixel(x + 3*pixelSize, y + i*pixelSize);
+                plotGlyphPixel(x + pixelSize, y + 6*pixelSize);
+                plotGlyphPixel(x + 2*pixelSize, y + 6*pixelSize);
             }
         }
     }
     
+public:
     void drawText(const std::string& text, float x, float y, float size, float r = 1, float g = 1, float b = 1) {
+        // A whole string is one batched draw since every glyph shares the atlas
+        bool ownBatch = !batching && !capture;
+        if (ownBatch) beginBatch();
+        
         float charWidth = size * 0.7f;
         for (size_t i = 0; i < text.length(); i++) {
             char c = text[i];
@@ -519,6 +874,8 @@ public:
             drawChar(c, x, y, size, r, g, b);
             x += charWidth;
         }
+        
+        if (ownBatch) endBatch();
     }
 };
 
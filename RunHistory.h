@@ -0,0 +1,284 @@
+#ifndef RUN_HISTORY_H
+#define RUN_HISTORY_H
+
+/**
+ * RunHistory
+ * ==========
+ *
+ * PURPOSE:
+ * Keeps every finished run (score, duration, character, top speed, time)
+ * for leaderboards and analytics, without making startup cost grow with
+ * the number of runs played.
+ *
+ * FILE FORMAT (native endianness, fixed-size records):
+ * - RunLogHeader: magic "MRUN", version, record size, and the best score /
+ *   coin total carried over from before the log existed
+ * - RunRecord x runCount, oldest first; never rewritten once written
+ * - RunSummary footer: magic "MSUM", run count and the running aggregates
+ *
+ * APPENDING:
+ * New records are written over the old footer followed by a fresh footer,
+ * in a single write. open() reads only the header and footer; record i is
+ * at a fixed offset, so reads are random access too.
+ *
+ * RECOVERY:
+ * If the footer is missing or disagrees with the file size (power loss
+ * mid-append), open() replays the records once, stops at the first one
+ * that is torn or implausible, and rewrites the footer there.
+ * Only a file shorter than a header is re-initialised in place. A bad
+ * magic, another version or another record size is never overwritten:
+ * open() moves the file to <path>.bad and starts a new log, or fails
+ * (with a warning) if a .bad file is already there.
+ *
+ * USED BY:
+ * - ScoreManager (its save thread appends, startup reads the summary)
+ *
+ * DEPENDENCIES:
+ * - POSIX file I/O (pread/pwrite/ftruncate), rename
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct RunRecord {
+    int32_t score;            // coins collected
+    int32_t durationTicks;    // fixed simulation ticks (60 per second)
+    int32_t character;
+    float maxSpeed;           // world speed when the run ended
+    int64_t timestamp;        // seconds since the Unix epoch
+};
+
+struct RunLogHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t recordSize;
+    int32_t baseBestScore;
+    int64_t baseTotalCoins;
+};
+
+struct RunSummary {
+    char magic[4];
+    uint32_t runCount;
+    int64_t totalCoins;       // including the header's base
+    int64_t totalTicks;
+    int32_t bestScore;        // including the header's base
+    float maxSpeed;
+};
+
+inline RunRecord makeRunRecord(int score, int durationTicks, int character, float maxSpeed) {
+    RunRecord r;
+    r.score = score;
+    r.durationTicks = durationTicks;
+    r.character = character;
+    r.maxSpeed = maxSpeed;
+    r.timestamp = (int64_t)std::time(nullptr);
+    return r;
+}
+
+static_assert(sizeof(RunRecord) == 24, "RunRecord layout is part of the file format");
+static_assert(sizeof(RunLogHeader) == 24, "RunLogHeader layout is part of the file format");
+static_assert(sizeof(RunSummary) == 32, "RunSummary layout is part of the file format");
+
+class RunHistory {
+public:
+    static const uint32_t VERSION = 1;
+
+private:
+    std::string path;
+    int fd;
+    RunLogHeader header;
+    RunSummary summary;
+
+    static off_t recordOffset(uint32_t index) {
+        return (off_t)sizeof(RunLogHeader) + (off_t)index * (off_t)sizeof(RunRecord);
+    }
+
+    static bool plausible(const RunRecord& r) {
+        return r.score >= 0 && r.durationTicks >= 0 &&
+               r.character >= 0 && r.character < 16 &&
+               r.maxSpeed >= 0 && r.maxSpeed < 1.0e6f;
+    }
+
+    static void accumulate(RunSummary& s, const RunRecord& r) {
+        s.runCount++;
+        s.totalCoins += r.score;
+        s.totalTicks += r.durationTicks;
+        if (r.score > s.bestScore) s.bestScore = r.score;
+        if (r.maxSpeed > s.maxSpeed) s.maxSpeed = r.maxSpeed;
+    }
+
+    void resetSummary() {
+        std::memcpy(summary.magic, "MSUM", 4);
+        summary.runCount = 0;
+        summary.totalCoins = header.baseTotalCoins;
+        summary.totalTicks = 0;
+        summary.bestScore = header.baseBestScore;
+        summary.maxSpeed = 0;
+    }
+
+    static bool readAll(int f, void* dst, size_t size, off_t offset) {
+        return pread(f, dst, size, offset) == (ssize_t)size;
+    }
+
+    static bool writeAll(int f, const void* src, size_t size, off_t offset) {
+        const char* p = static_cast<const char*>(src);
+        while (size > 0) {
+            ssize_t n = pwrite(f, p, size, offset);
+            if (n <= 0) return false;
+            p += n;
+            size -= (size_t)n;
+            offset += n;
+        }
+        return true;
+    }
+
+    // Rebuild the footer from the records; returns false if unreadable
+    bool recover(off_t fileSize) {
+        resetSummary();
+        off_t available = fileSize - (off_t)sizeof(RunLogHeader);
+        uint32_t candidates = available > 0 ? (uint32_t)(available / (off_t)sizeof(RunRecord)) : 0;
+
+        RunRecord r;
+        for (uint32_t i = 0; i < candidates; i++) {
+            if (!readAll(fd, &r, sizeof(r), recordOffset(i))) break;
+            if (std::memcmp(&r, "MSUM", 4) == 0 || !plausible(r)) break;
+            accumulate(summary, r);
+        }
+
+        off_t end = recordOffset(summary.runCount);
+        if (!writeAll(fd, &summary, sizeof(summary), end)) return false;
+        return ftruncate(fd, end + (off_t)sizeof(summary)) == 0;
+    }
+
+public:
+    RunHistory() : fd(-1) {
+        std::memset(&header, 0, sizeof(header));
+        resetSummary();
+    }
+
+    ~RunHistory() { close(); }
+
+    RunHistory(const RunHistory&) = delete;
+    RunHistory& operator=(const RunHistory&) = delete;
+
+    // Open (or create) the log. 'baseBest' / 'baseCoins' seed a new log with
+    // totals from before run history existed; ignored if the log exists.
+    bool open(const std::string& file, int baseBest, long long baseCoins) {
+        close();
+        path = file;
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+
+        bool created = st.st_size < (off_t)sizeof(RunLogHeader);
+        if (!created) {
+            const char* problem = nullptr;
+            if (!readAll(fd, &header, sizeof(header), 0)) problem = "unreadable header";
+            else if (std::memcmp(header.magic, "MRUN", 4) != 0) problem = "not a run log";
+            else if (header.version != VERSION) problem = "unknown version";
+            else if (header.recordSize != sizeof(RunRecord)) problem = "unknown record size";
+            if (problem) {
+                // Someone else's file or a newer format: keep it, start a new log
+                std::string kept = path + ".bad";
+                struct stat existing;
+                close();
+                if (::stat(kept.c_str(), &existing) == 0 || std::rename(path.c_str(), kept.c_str()) != 0) {
+                    std::cerr << "Warning: " << path << ": " << problem
+                              << ", and it cannot be moved to " << kept << std::endl;
+                    return false;
+                }
+                std::cerr << "Warning: " << path << ": " << problem << ", moved to " << kept << std::endl;
+                fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+                if (fd < 0) return false;
+                created = true;
+            }
+        }
+        if (created) {
+            // New (or torn before its header was complete): start from the carried-over totals
+            std::memcpy(header.magic, "MRUN", 4);
+            header.version = VERSION;
+            header.recordSize = sizeof(RunRecord);
+            header.baseBestScore = baseBest;
+            header.baseTotalCoins = baseCoins;
+            resetSummary();
+            if (ftruncate(fd, 0) != 0 ||
+                !writeAll(fd, &header, sizeof(header), 0) ||
+                !writeAll(fd, &summary, sizeof(summary), sizeof(header))) {
+                close();
+                return false;
+            }
+            return true;
+        }
+
+        off_t footer = st.st_size - (off_t)sizeof(RunSummary);
+        bool validFooter = footer >= (off_t)sizeof(RunLogHeader) &&
+                           readAll(fd, &summary, sizeof(summary), footer) &&
+                           std::memcmp(summary.magic, "MSUM", 4) == 0 &&
+                           recordOffset(summary.runCount) == footer;
+        if (!validFooter && !recover(st.st_size)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Append runs and the updated footer in one write
+    bool append(const RunRecord* records, size_t count) {
+        if (fd < 0 || count == 0) return fd >= 0;
+
+        RunSummary next = summary;
+        for (size_t i = 0; i < count; i++) accumulate(next, records[i]);
+        const unsigned char* recordBytes = reinterpret_cast<const unsigned char*>(records);
+        const unsigned char* summaryBytes = reinterpret_cast<const unsigned char*>(&next);
+        std::vector<unsigned char> buffer(recordBytes, recordBytes + count * sizeof(RunRecord));
+        buffer.insert(buffer.end(), summaryBytes, summaryBytes + sizeof(next));
+
+        if (!writeAll(fd, buffer.data(), buffer.size(), recordOffset(summary.runCount))) return false;
+        summary = next;
+        return true;
+    }
+
+    // Read 'count' records starting at 'first' (oldest is 0)
+    std::vector<RunRecord> read(uint32_t first, uint32_t count) const {
+        std::vector<RunRecord> out;
+        if (fd < 0 || first >= summary.runCount) return out;
+        if (count > summary.runCount - first) count = summary.runCount - first;
+        out.resize(count);
+        if (!readAll(fd, out.data(), count * sizeof(RunRecord), recordOffset(first))) out.clear();
+        return out;
+    }
+
+    // The most recent 'count' runs, oldest first
+    std::vector<RunRecord> recent(uint32_t count) const {
+        uint32_t first = count < summary.runCount ? summary.runCount - count : 0;
+        return read(first, count);
+    }
+
+    uint32_t getRunCount() const { return summary.runCount; }
+    int getBestScore() const { return summary.bestScore; }
+    long long getTotalCoins() const { return summary.totalCoins; }
+    long long getTotalTicks() const { return summary.totalTicks; }
+    float getMaxSpeed() const { return summary.maxSpeed; }
+};
+
+#endif
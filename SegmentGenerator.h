@@ -0,0 +1,260 @@
+#ifndef SEGMENT_GENERATOR_H
+#define SEGMENT_GENERATOR_H
+
+/**
+ * SegmentGenerator
+ * ================
+ *
+ * PURPOSE:
+ * Decides what the track contains ahead of the player (which obstacles
+ * fly, where coins hang, how wide each recycled metro's gap is) in
+ * fixed-length TrackSegments, so GameWorld's tick only copies ready data.
+ *
+ * SEGMENTS:
+ * - Segment i covers world ticks i * SEGMENT_TICKS + 1 .. (i + 1) * SEGMENT_TICKS
+ *   (GameWorld counts updates from 1)
+ * - Obstacles and coins keep their fixed cadence (every GameTuning
+ *   obstacleInterval / coinInterval seconds of ticks); a segment lists the
+ *   spawns that fall into its window with their exact world tick
+ * - A segment holds at most MAX_OBSTACLES / MAX_COINS spawns, so the
+ *   period must be at least SEGMENT_TICKS / MAX_* ticks (8). build()
+ *   asserts it; GameWorld::tuningProblem rejects tunings that break it.
+ * - Metros recycle by distance, not time: recycles while segment i is
+ *   current take its metro gaps in order (wrapping if there are more).
+ *   Gaps are drawn from the layout's [metroGapMin, metroGapMax].
+ * - build() is a pure function of (seed, index): its Random is seeded with
+ *   Random::deriveSeed(seed, index), so it does not matter which thread
+ *   builds a segment or when. Runs stay reproducible from their seed.
+ *
+ * THREADING:
+ * - Inline mode (default, headless): next() builds each segment on demand
+ * - Worker mode (startWorker): a background thread builds up to
+ *   QUEUE_CAPACITY - 1 segments ahead (~12 s of play) into an SpscQueue;
+ *   next() pops them, dropping ones from an older session. If the worker
+ *   is behind, next() builds inline instead of waiting.
+ * - restart(seed) starts a new session; the worker follows without a join
+ *
+ * USED BY:
+ * - GameWorld (one generator per world)
+ *
+ * DEPENDENCIES:
+ * - Random.h, SpscQueue.h, GameConfig.h (SIM_DT); no GL
+ */
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "GameConfig.h"
+#include "Random.h"
+#include "SpscQueue.h"
+
+struct ObstacleSpawn {
+    int32_t tick;        // world tick (1-based update count) to spawn on
+    bool flying;
+};
+
+struct CoinSpawn {
+    int32_t tick;
+    float y;
+};
+
+struct TrackSegment {
+    static const int SEGMENT_TICKS = 240;          // 4 s at 60 ticks/s
+    static const int MAX_OBSTACLES = 32;           // room for bench_world's densest tracks
+    static const int MAX_COINS = 32;
+    static const int METRO_GAPS = 8;
+
+    int64_t index;
+    uint32_t session;    // generator session that built it
+    int obstacleCount;
+    ObstacleSpawn obstacles[MAX_OBSTACLES];
+    int coinCount;
+    CoinSpawn coins[MAX_COINS];
+    float metroGaps[METRO_GAPS];
+};
+
+// The fixed rules segments are built from
+struct TrackLayout {
+    float groundY;            // metro top, coins hang above it
+    float metroGapMin;        // recycled metros' gaps, whole pixels in [min, max]
+    float metroGapMax;
+    float obstacleInterval;   // seconds between obstacle spawns
+    float coinInterval;
+};
+
+class SegmentGenerator {
+public:
+    static const size_t QUEUE_CAPACITY = 4;
+
+private:
+    TrackLayout layout;
+    int obstaclePeriod;       // ticks between spawns
+    int coinPeriod;
+
+    // Session requested by the consumer; read by the worker under requestMutex
+    uint64_t seed;
+    uint32_t session;           // 0 until the first restart()
+
+    // Consumer's own copy, so next() needs no lock
+    uint64_t currentSeed;
+    uint32_t currentSession;
+
+    SpscQueue<TrackSegment, QUEUE_CAPACITY> queue;
+    std::thread worker;
+    std::mutex requestMutex;
+    std::condition_variable wake;         // new session, room in the queue, or stop
+    bool stopping;
+    unsigned inlineBuilds;
+
+    void workerLoop() {
+        uint32_t builtSession = 0;
+        int64_t nextIndex = 0;
+        std::unique_lock<std::mutex> lock(requestMutex);
+        for (;;) {
+            wake.wait(lock, [&] {
+                return stopping || (session != 0 && (session != builtSession || !queueFull()));
+            });
+            if (stopping) return;
+            if (session != builtSession) {
+                builtSession = session;
+                nextIndex = 0;
+            }
+            uint64_t buildSeed = seed;
+            lock.unlock();
+
+            TrackSegment segment = build(buildSeed, nextIndex, builtSession);
+            bool pushed = queue.push(segment);
+
+            lock.lock();
+            if (pushed) nextIndex++;
+        }
+    }
+
+    bool queueFull() const {
+        return queue.size() >= QUEUE_CAPACITY - 1;
+    }
+
+public:
+    // Ticks until a timer that adds 'dt' per tick and fires when it exceeds
+    // 'interval' fires, then resets to 0 (GameWorld's original spawn timers)
+    static int spawnPeriod(float interval, float dt) {
+        float timer = 0;
+        int ticks = 0;
+        do {
+            timer += dt;
+            ticks++;
+        } while (!(timer > interval));
+        return ticks;
+    }
+    
+    explicit SegmentGenerator(const TrackLayout& trackLayout)
+        : layout(trackLayout), seed(0), session(0), currentSeed(0), currentSession(0),
+          stopping(false), inlineBuilds(0) {
+        obstaclePeriod = spawnPeriod(layout.obstacleInterval, SIM_DT);
+        coinPeriod = spawnPeriod(layout.coinInterval, SIM_DT);
+    }
+
+    ~SegmentGenerator() {
+        stopWorker();
+    }
+
+    SegmentGenerator(const SegmentGenerator&) = delete;
+    SegmentGenerator& operator=(const SegmentGenerator&) = delete;
+
+    // Segment 'index' for 'sessionSeed'; the same arguments always give the same segment
+    TrackSegment build(uint64_t sessionSeed, int64_t index, uint32_t tag) const {
+        TrackSegment segment;
+        segment.index = index;
+        segment.session = tag;
+        segment.obstacleCount = 0;
+        segment.coinCount = 0;
+
+        Random rng(Random::deriveSeed(sessionSeed, (uint64_t)index));
+        int32_t first = (int32_t)(index * TrackSegment::SEGMENT_TICKS) + 1;
+        int32_t last = first + TrackSegment::SEGMENT_TICKS - 1;
+
+        // GameWorld::tuningProblem keeps periods long enough that neither
+        // list fills up; a full list would silently thin the track
+        for (int32_t t = ((first + obstaclePeriod - 1) / obstaclePeriod) * obstaclePeriod;
+             t <= last; t += obstaclePeriod) {
+            assert(segment.obstacleCount < TrackSegment::MAX_OBSTACLES);
+            if (segment.obstacleCount == TrackSegment::MAX_OBSTACLES) break;
+            ObstacleSpawn& spawn = segment.obstacles[segment.obstacleCount++];
+            spawn.tick = t;
+            spawn.flying = rng.coinFlip();
+        }
+        for (int32_t t = ((first + coinPeriod - 1) / coinPeriod) * coinPeriod;
+             t <= last; t += coinPeriod) {
+            assert(segment.coinCount < TrackSegment::MAX_COINS);
+            if (segment.coinCount == TrackSegment::MAX_COINS) break;
+            CoinSpawn& spawn = segment.coins[segment.coinCount++];
+            spawn.tick = t;
+            spawn.y = layout.groundY - 150 - (float)rng.below(100);
+        }
+        // Drawn last so a range change leaves obstacles and coins alone; a
+        // fixed gap draws nothing
+        uint32_t spread = layout.metroGapMax > layout.metroGapMin ?
+                          (uint32_t)(layout.metroGapMax - layout.metroGapMin) : 0;
+        for (int i = 0; i < TrackSegment::METRO_GAPS; i++) {
+            segment.metroGaps[i] = layout.metroGapMin + (spread ? (float)rng.below(spread + 1) : 0.0f);
+        }
+        return segment;
+    }
+
+    // Start building ahead on a background thread (GL builds only need this)
+    void startWorker() {
+        if (worker.joinable()) return;
+        stopping = false;
+        worker = std::thread(&SegmentGenerator::workerLoop, this);
+    }
+
+    void stopWorker() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // New session: segments from the previous one are dropped as they come out
+    void restart(uint64_t sessionSeed) {
+        currentSeed = sessionSeed;
+        currentSession++;
+        {
+            std::lock_guard<std::mutex> lock(requestMutex);
+            seed = currentSeed;
+            session = currentSession;
+        }
+        wake.notify_one();
+    }
+
+    // Segment 'index' of the current session
+    TrackSegment next(int64_t index) {
+        if (worker.joinable()) {
+            TrackSegment segment;
+            bool popped = false;
+            bool found = false;
+            while (!found && queue.pop(segment)) {
+                popped = true;
+                found = segment.session == currentSession && segment.index == index;
+            }
+            if (popped) {
+                // Taking the lock orders this wake-up after the worker's wait
+                { std::lock_guard<std::mutex> lock(requestMutex); }
+                wake.notify_one();
+            }
+            if (found) return segment;
+        }
+        inlineBuilds++;
+        return build(currentSeed, index, currentSession);
+    }
+
+    // How often next() had to build on the calling thread
+    unsigned getInlineBuilds() const { return inlineBuilds; }
+};
+
+#endif
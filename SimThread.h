@@ -0,0 +1,215 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+/**
+ * SimThread
+ * =========
+ *
+ * PURPOSE:
+ * Optional (--threaded) split of a run into a simulation thread, which
+ * steps the Simulation at a fixed 60 Hz on its own clock, and the GL
+ * thread, which only draws the newest WorldSnapshot. A slow frame no
+ * longer delays ticks, and a slow tick no longer costs a frame.
+ *
+ * SNAPSHOTS:
+ * - After every tick the thread copies what a frame needs (player,
+ *   previous Y, metros, the obstacle and coin rings, HUD values) into the
+ *   write slot of a TripleBuffer and publishes it; nothing allocates once
+ *   the metro vector has its capacity
+ * - Each snapshot carries the wall time its tick ends at, so the GL thread
+ *   interpolates exactly like the single-threaded loop does with its
+ *   accumulator
+ * - SimEvent bits are ORed into an atomic, so sounds are not lost when the
+ *   GL thread skips snapshots
+ *
+ * INPUT AND LATENCY:
+ * - The GL thread forwards key events to a second InputManager
+ *   (InputManager::forwardTo); the thread pumps it before every tick, the
+ *   step function consumes that tick's presses, the rest wait
+ * - The oldest press consumed since the GL thread last presented is kept
+ *   in every snapshot until a presented() acknowledges it
+ *
+ * LIFECYCLE:
+ * start() for each run; the thread ends by itself when the step function
+ * returns false (the last snapshot then has 'ended' set), or on stop().
+ * Anything the step function touches (Simulation, recordings) belongs to
+ * the thread between start() and join()/stop().
+ *
+ * TIMING:
+ * Ticks are scheduled at fixed SIM_DT deadlines on glfwGetTime(), the
+ * clock key events are stamped with. After a stall of more than
+ * MAX_LAG_TICKS the schedule restarts from now instead of catching up.
+ *
+ * USED BY:
+ * - Game (threaded mode)
+ *
+ * DEPENDENCIES:
+ * - Simulation.h, TripleBuffer.h, InputManager.h; GLFW for the clock
+ */
+
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "Simulation.h"
+#include "InputManager.h"
+#include "TripleBuffer.h"
+
+// Everything renderPlaying() draws, from one tick
+struct WorldSnapshot {
+    Player player;
+    float prevPlayerY;
+    float lastScrollStep;
+    int coinsCollected;
+    std::vector<Metro> metros;
+    ObstacleRing obstacles;
+    CoinRing coins;
+
+    double tickTime;        // glfwGetTime() the tick ends at
+    uint64_t serial;        // ticks published this run, 1 for the first
+    bool hasPress;
+    double pressTime;       // oldest consumed press not yet acknowledged
+    uint64_t pressSerial;   // snapshot it was first published in
+    bool ended;
+
+    WorldSnapshot() : prevPlayerY(0), lastScrollStep(0), coinsCollected(0), tickTime(0),
+        serial(0), hasPress(false), pressTime(0), pressSerial(0), ended(false) {}
+
+    void capture(const Simulation& sim) {
+        const GameWorld& world = sim.getWorld();
+        player = sim.getPlayer();
+        prevPlayerY = sim.getPrevPlayerY();
+        lastScrollStep = world.getLastScrollStep();
+        coinsCollected = world.getCoinsCollected();
+        metros = world.getMetros();
+        obstacles = world.getObstacles();
+        coins = world.getCoins();
+    }
+};
+
+class SimThread {
+public:
+    // One tick ending at the given time; false ends the run
+    typedef std::function<bool(double)> StepFunction;
+
+    static const int MAX_LAG_TICKS = 5;
+
+private:
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::atomic<uint32_t> events;
+    std::atomic<uint64_t> shownSerial;
+    TripleBuffer<WorldSnapshot> snapshots;
+    uint64_t reportedPressSerial;   // GL thread
+
+    void run(Simulation* sim, InputManager* input, StepFunction step) {
+        double next = glfwGetTime() + SIM_DT;
+        uint64_t serial = 0;
+        bool havePress = false;
+        double pressTime = 0;
+        uint64_t pressSerial = 0;
+        bool alive = true;
+
+        while (alive && !stopping.load(std::memory_order_relaxed)) {
+            double now = glfwGetTime();
+            if (now < next) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(next - now));
+                continue;
+            }
+            if (now - next > MAX_LAG_TICKS * SIM_DT) next = now;
+
+            input->pumpEvents();
+            alive = step(next);
+            // Presses after this tick wait for the next one
+            input->discardUntil(next);
+            serial++;
+
+            if (havePress && shownSerial.load(std::memory_order_acquire) >= pressSerial) {
+                havePress = false;
+            }
+            double consumed;
+            if (input->takeConsumedPressTime(consumed) && !havePress) {
+                havePress = true;
+                pressTime = consumed;
+                pressSerial = serial;
+            }
+
+            WorldSnapshot& snap = snapshots.writeBuffer();
+            snap.capture(*sim);
+            snap.tickTime = next;
+            snap.serial = serial;
+            snap.hasPress = havePress;
+            snap.pressTime = pressTime;
+            snap.pressSerial = pressSerial;
+            snap.ended = !alive;
+            snapshots.publish();
+            next += SIM_DT;
+        }
+    }
+
+public:
+    SimThread() : stopping(false), events(0), shownSerial(0), reportedPressSerial(0) {}
+    ~SimThread() { stop(); }
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // 'sim' has just been reset; its state becomes the first snapshot
+    void start(Simulation& sim, InputManager& input, StepFunction step) {
+        stop();
+        WorldSnapshot first;
+        first.capture(sim);
+        first.tickTime = glfwGetTime();
+        snapshots.reset(first);
+        snapshots.update();
+        events.store(0);
+        shownSerial.store(0);
+        reportedPressSerial = 0;
+        stopping.store(false);
+        thread = std::thread(&SimThread::run, this, &sim, &input, step);
+    }
+
+    // Ask the thread to finish its current tick and wait for it
+    void stop() {
+        stopping.store(true);
+        join();
+    }
+
+    // After the last snapshot said 'ended'
+    void join() {
+        if (thread.joinable()) thread.join();
+    }
+
+    // Simulation thread: queue sound events for the GL thread
+    void postEvents(uint32_t bits) {
+        if (bits) events.fetch_or(bits, std::memory_order_relaxed);
+    }
+
+    // GL thread
+    uint32_t takeEvents() { return events.exchange(0, std::memory_order_relaxed); }
+
+    // GL thread: switch to the newest snapshot, if there is one
+    const WorldSnapshot& latest() {
+        snapshots.update();
+        return snapshots.readBuffer();
+    }
+
+    // GL thread: the current snapshot was presented. Returns the time of a
+    // press it showed for the first time, if any.
+    bool presented(double& pressTime) {
+        const WorldSnapshot& snap = snapshots.readBuffer();
+        shownSerial.store(snap.serial, std::memory_order_release);
+        if (!snap.hasPress || snap.pressSerial <= reportedPressSerial) return false;
+        reportedPressSerial = snap.pressSerial;
+        pressTime = snap.pressTime;
+        return true;
+    }
+
+    // Started and not joined yet (it may have published its last snapshot)
+    bool isActive() const { return thread.joinable(); }
+};
+
+#endif
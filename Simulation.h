@@ -0,0 +1,170 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/**
+ * Simulation Class
+ * ================
+ * 
+ * PURPOSE:
+ * One play session of the game without any window, GL or audio: the
+ * GameWorld, the Player and the per-tick rules that tie them together.
+ * 
+ * RESPONSIBILITIES:
+ * - Reset a session for a chosen character and world seed
+ * - Apply one tick of input (jump / ability) and step the player physics
+ * - Step the world (scrolling, spawning, coin pickup)
+ * - Detect the end of the run (obstacle hit or fall through a gap) and
+ *   remember which one it was
+ * - Remember the player's previous Y for render interpolation
+ * - Report what happened in the last tick (SimEvent bits) so the game can
+ *   play sounds without the simulation knowing about audio
+ * 
+ * TICK ORDER (same as the original Game loop):
+ * 1. Apply input
+ * 2. Player physics (platform check, gravity, landing)
+ * 3. GameWorld::update
+ * 4. Collision check -> game over
+ * 
+ * USED BY:
+ * - Game class (interactive play)
+ * - headless_sim (scripted/random input, no display needed)
+ * 
+ * TUNING:
+ * The GameTuning given at construction (speed ramp, spawn intervals,
+ * ability timings) applies to every session; the default is the game's.
+ * 
+ * DEPENDENCIES:
+ * - GameWorld.h, Player.h, GameTuning.h (no GL, GLFW or SFML)
+ */
+
+#include "GameWorld.h"
+#include "Player.h"
+#include "GameTuning.h"
+
+// Input for one simulation tick
+struct TickInput {
+    bool jump;
+    bool ability;
+    
+    TickInput() : jump(false), ability(false) {}
+};
+
+// What happened during the last tick (Simulation::getEvents)
+enum SimEvent : uint32_t {
+    SIM_EVENT_JUMP = 1 << 0,       // a jump or double jump started
+    SIM_EVENT_ABILITY = 1 << 1,    // the ability was activated
+    SIM_EVENT_COIN = 1 << 2,       // at least one coin was collected
+    SIM_EVENT_CRASH = 1 << 3       // the run ended
+};
+
+// How a run ended (Simulation::getRunEnd)
+enum class RunEnd {
+    NONE,        // still running
+    OBSTACLE,    // hit an obstacle without the shield
+    FALL         // dropped through a gap
+};
+
+class Simulation {
+private:
+    GameTuning tuning;
+    GameWorld world;
+    Player player;
+    float prevPlayerY;
+    bool gameOver;
+    RunEnd runEnd;
+    int ticks;
+    uint32_t events;
+    
+    void updatePlayer(float deltaTime) {
+        bool standingOnPlatform = world.isPlayerOnPlatform(player);
+        float groundY = world.getGroundY(player);
+        
+        if (standingOnPlatform && !player.isJumping) {
+            player.update(groundY, deltaTime);
+        } else {
+            if (!player.isJumping && player.y >= groundY) {
+                player.isJumping = true;
+                player.velocityY = 1.0f;
+            }
+            player.y += player.velocityY;
+            player.velocityY += 0.5f;
+            
+            if (player.y >= groundY && standingOnPlatform) {
+                player.y = groundY;
+                player.velocityY = 0;
+                player.isJumping = false;
+                player.hasDoubleJumped = false;
+            }
+        }
+    }
+    
+public:
+    explicit Simulation(const GameTuning& gameTuning = GameTuning())
+        : tuning(gameTuning), world(gameTuning), prevPlayerY(0), gameOver(false),
+          runEnd(RunEnd::NONE), ticks(0), events(0) {
+        reset(0, 0);
+    }
+    
+    // The same character, seed and per-tick input always give the same run
+    void reset(int character, uint64_t seed) {
+        player = Player();
+        player.headIndex = character;
+        world.init(seed);
+        player.y = world.getGroundY(player);
+        prevPlayerY = player.y;
+        gameOver = false;
+        runEnd = RunEnd::NONE;
+        ticks = 0;
+        events = 0;
+    }
+    
+    // Advance one fixed step. Returns false once the run has ended.
+    bool tick(const TickInput& input, float dt) {
+        events = 0;
+        if (gameOver) return false;
+        
+        prevPlayerY = player.y;
+        if (input.jump) {
+            float velocityBefore = player.velocityY;
+            player.jump();
+            if (player.velocityY != velocityBefore) events |= SIM_EVENT_JUMP;
+        }
+        if (input.ability) {
+            bool ready = player.abilityCooldown <= 0;
+            player.activateAbility(tuning);
+            if (ready) events |= SIM_EVENT_ABILITY;
+        }
+        
+        int coinsBefore = world.getCoinsCollected();
+        updatePlayer(dt);
+        world.update(dt, player);
+        ticks++;
+        if (world.getCoinsCollected() != coinsBefore) events |= SIM_EVENT_COIN;
+        
+        // The player has not moved since world.update(), so its hit mask holds
+        if (world.checkObstacleHitLastTick(player)) {
+            runEnd = RunEnd::OBSTACLE;
+        } else if (world.checkFallThrough(player)) {
+            runEnd = RunEnd::FALL;
+        }
+        if (runEnd != RunEnd::NONE) {
+            gameOver = true;
+            events |= SIM_EVENT_CRASH;
+        }
+        return !gameOver;
+    }
+    
+    // Interactive builds generate track segments ahead on a worker thread
+    void startSegmentWorker() { world.startSegmentWorker(); }
+    
+    bool isGameOver() const { return gameOver; }
+    RunEnd getRunEnd() const { return runEnd; }
+    const GameTuning& getTuning() const { return tuning; }
+    uint32_t getEvents() const { return events; }
+    int getTicks() const { return ticks; }
+    float getPrevPlayerY() const { return prevPlayerY; }
+    const GameWorld& getWorld() const { return world; }
+    const Player& getPlayer() const { return player; }
+};
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef SOUND_BANK_H
+#define SOUND_BANK_H
+
+/**
+ * SoundBank
+ * =========
+ *
+ * PURPOSE:
+ * Short sound effects (jump, coin, ability, crash) that gameplay can fire
+ * from the update loop without hitching: everything is decoded at load
+ * time and play() neither allocates nor touches the file system.
+ *
+ * LOADING:
+ * - beginLoading() decodes every effect into an sf::SoundBuffer on a
+ *   background thread, in parallel with AssetManager's texture workers
+ * - A missing sfx/<name>.wav is replaced by a short synthesized tone, so
+ *   the game never runs silent for lack of files
+ * - pump() (GL thread, every frame) binds the voices once decoding is done
+ *
+ * VOICES:
+ * - A fixed pool of MAX_VOICES sf::Sound voices; each effect owns
+ *   SFX_VOICES[effect] of them (checked at compile time), bound to its
+ *   buffer once. sf::Sound::setBuffer registers the sound
+ *   with the buffer (an allocation inside SFML), so voices never rebind.
+ * - play() takes a voice of that effect that is not playing; if all are
+ *   busy it steals the one started longest ago
+ *
+ * USED BY:
+ * - AssetManager (owns the bank, forwards playSound)
+ *
+ * DEPENDENCIES:
+ * - SFML Audio
+ */
+
+#include <SFML/Audio.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum SoundEffect {
+    SFX_JUMP,
+    SFX_COIN,
+    SFX_ABILITY,
+    SFX_CRASH,
+    SFX_COUNT
+};
+
+// Voices each effect owns, in SoundEffect order
+constexpr int SFX_VOICES[SFX_COUNT] = {3, 4, 2, 1};
+
+constexpr int totalSfxVoices() {
+    int total = 0;
+    for (int i = 0; i < SFX_COUNT; i++) total += SFX_VOICES[i];
+    return total;
+}
+
+class SoundBank {
+public:
+    static const int MAX_VOICES = 12;
+    static const unsigned SAMPLE_RATE = 44100;   // synthesized fallbacks
+    static_assert(totalSfxVoices() <= MAX_VOICES, "SFX_VOICES needs more than MAX_VOICES voices");
+
+private:
+    struct EffectInfo {
+        const char* path;
+        float volume;
+        // Synthesized fallback: frequency sweep over 'seconds', or noise
+        float startHz, endHz, seconds;
+        bool noise;
+    };
+
+    static const EffectInfo& info(int effect) {
+        static const EffectInfo effects[SFX_COUNT] = {
+            {"sfx/jump.wav", 70, 300, 700, 0.12f, false},
+            {"sfx/coin.wav", 60, 1200, 1800, 0.08f, false},
+            {"sfx/ability.wav", 80, 400, 1600, 0.35f, false},
+            {"sfx/crash.wav", 100, 0, 0, 0.5f, true}
+        };
+        return effects[effect];
+    }
+
+    sf::SoundBuffer buffers[SFX_COUNT];
+    sf::Sound voices[MAX_VOICES];
+    uint32_t voiceStarted[MAX_VOICES];    // play serial, 0 = never
+    int firstVoice[SFX_COUNT];
+    bool loaded[SFX_COUNT];               // written by the loader before 'decoded'
+
+    std::thread loader;
+    std::atomic<bool> decoded;
+    bool ready;
+    uint32_t serial;
+    unsigned steals;
+
+    static void synthesize(const EffectInfo& effect, std::vector<sf::Int16>& samples) {
+        size_t count = (size_t)(effect.seconds * SAMPLE_RATE);
+        samples.resize(count);
+        double phase = 0;
+        uint32_t noise = 0x12345678u;
+        for (size_t i = 0; i < count; i++) {
+            double t = (double)i / count;
+            double envelope = (1.0 - t) * (1.0 - t);
+            double value;
+            if (effect.noise) {
+                noise = noise * 1664525u + 1013904223u;
+                value = (double)(int32_t)noise / 2147483648.0;
+            } else {
+                double hz = effect.startHz + (effect.endHz - effect.startHz) * t;
+                phase += 2.0 * 3.14159265358979 * hz / SAMPLE_RATE;
+                value = std::sin(phase);
+            }
+            samples[i] = (sf::Int16)(value * envelope * 12000.0);
+        }
+    }
+
+    void loadWorker() {
+        std::vector<sf::Int16> samples;
+        for (int i = 0; i < SFX_COUNT; i++) {
+            const EffectInfo& effect = info(i);
+            loaded[i] = buffers[i].loadFromFile(effect.path);
+            if (!loaded[i]) {
+                synthesize(effect, samples);
+                loaded[i] = buffers[i].loadFromSamples(samples.data(), samples.size(), 1, SAMPLE_RATE);
+            }
+        }
+        decoded.store(true);
+    }
+
+    void bindVoices() {
+        if (loader.joinable()) loader.join();
+        int next = 0;
+        for (int i = 0; i < SFX_COUNT; i++) {
+            const EffectInfo& effect = info(i);
+            firstVoice[i] = next;
+            for (int v = 0; v < SFX_VOICES[i]; v++, next++) {
+                if (loaded[i]) voices[next].setBuffer(buffers[i]);
+                voices[next].setVolume(effect.volume);
+            }
+            if (!loaded[i]) std::cerr << "Warning: no sound for " << effect.path << "\n";
+        }
+        ready = true;
+        std::cout << "Sound effects ready (" << next << " voices)" << std::endl;
+    }
+
+public:
+    SoundBank() : decoded(false), ready(false), serial(0), steals(0) {
+        for (int i = 0; i < SFX_COUNT; i++) {
+            firstVoice[i] = 0;
+            loaded[i] = false;
+        }
+        for (int v = 0; v < MAX_VOICES; v++) voiceStarted[v] = 0;
+    }
+
+    ~SoundBank() {
+        if (loader.joinable()) loader.join();
+        for (int v = 0; v < MAX_VOICES; v++) voices[v].stop();
+    }
+
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    void beginLoading() {
+        if (loader.joinable() || ready) return;
+        loader = std::thread(&SoundBank::loadWorker, this);
+    }
+
+    // Non-blocking: finish setup once the loader is done
+    void pump() {
+        if (!ready && decoded.load()) bindVoices();
+    }
+
+    // Block until the effects are playable
+    void finishLoading() {
+        if (ready || !loader.joinable()) return;
+        loader.join();
+        bindVoices();
+    }
+
+    bool isReady() const { return ready; }
+
+    // Safe from the update loop: no allocation, no I/O. Ignored until loaded.
+    void play(SoundEffect effect) {
+        if (!ready || !loaded[effect]) return;
+        int first = firstVoice[effect];
+        int last = first + SFX_VOICES[effect];
+
+        int chosen = -1;
+        for (int v = first; v < last; v++) {
+            if (voices[v].getStatus() != sf::SoundSource::Playing) {
+                chosen = v;
+                break;
+            }
+        }
+        if (chosen < 0) {
+            chosen = first;
+            for (int v = first + 1; v < last; v++) {
+                if (voiceStarted[v] < voiceStarted[chosen]) chosen = v;
+            }
+            voices[chosen].stop();
+            steals++;
+        }
+        voiceStarted[chosen] = ++serial;
+        voices[chosen].play();
+    }
+
+    unsigned getSteals() const { return steals; }
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+/**
+ * SpscQueue
+ * =========
+ *
+ * PURPOSE:
+ * Fixed-capacity, lock-free ring buffer for exactly one producer thread and
+ * one consumer thread. Neither side ever blocks or allocates, so it is safe
+ * to push from callbacks and hot loops.
+ *
+ * RULES:
+ * - Only one thread may call push(), only one may call pop()
+ * - push() returns false when full; the caller decides whether to drop
+ * - Capacity must be a power of two; one slot is never used
+ *
+ * USED BY:
+ * - InputManager (GLFW key callback -> game loop; GL thread -> sim thread
+ *   with --threaded)
+ * - SegmentGenerator (worker thread -> GameWorld)
+ *
+ * DEPENDENCIES:
+ * - None (std::atomic only)
+ */
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+private:
+    static const size_t MASK = Capacity - 1;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> tail;   // next slot to write (producer)
+    alignas(64) std::atomic<size_t> head;   // next slot to read (consumer)
+    alignas(64) T slots[Capacity];
+
+public:
+    SpscQueue() : tail(0), head(0) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) & MASK;
+        if (next == head.load(std::memory_order_acquire)) return false;
+        slots[t] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only
+    bool pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        out = slots[h];
+        head.store((h + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called while the other side is active
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        return (tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)) & MASK;
+    }
+};
+
+#endif
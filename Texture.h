@@ -3,25 +3,95 @@
 #include "stb_image.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+// CPU-side result of decoding an image file (bottom row first)
+struct DecodedImage {
+    std::string path;
+    unsigned char* pixels;
+    int width, height, channels;
+    
+    DecodedImage() : pixels(nullptr), width(0), height(0), channels(0) {}
+};
+
+// A full mip pyramid of RGBA8 pixels, level 0 first, each bottom row first
+struct MipChain {
+    static const int MAX_LEVELS = 16;
+    int levels;
+    int width[MAX_LEVELS];
+    int height[MAX_LEVELS];
+    const unsigned char* data[MAX_LEVELS];
+    
+    MipChain() : levels(0) {}
+    size_t levelSize(int i) const { return (size_t)width[i] * height[i] * 4; }
+};
+
+// Largest size an image is kept at, and whether it gets mipmaps. Images
+// bigger than the box are scaled down on the CPU (aspect kept) before
+// upload; mipmaps only pay off where the texture is drawn minified.
+struct TextureLimit {
+    int maxWidth, maxHeight;   // 0 = unlimited
+    bool mipmaps;
+    
+    TextureLimit(int w = 0, int h = 0, bool mips = true) : maxWidth(w), maxHeight(h), mipmaps(mips) {}
+    
+    // Size a w x h image is stored at
+    void fit(int w, int h, int& outW, int& outH) const {
+        double scale = 1.0;
+        if (maxWidth > 0 && w > maxWidth) scale = (double)maxWidth / w;
+        if (maxHeight > 0 && h * scale > maxHeight) scale = (double)maxHeight / h;
+        outW = scale < 1.0 ? std::max(1, (int)(w * scale + 0.5)) : w;
+        outH = scale < 1.0 ? std::max(1, (int)(h * scale + 0.5)) : h;
+    }
+};
+
+// Area-average downscale (dw <= w, dh <= h). With 4 channels the color is
+// weighted by alpha so transparent texels don't darken the edges.
+inline void downscalePixels(const unsigned char* src, int w, int h, int channels,
+                            unsigned char* dst, int dw, int dh) {
+    for (int y = 0; y < dh; y++) {
+        int y0 = (int)((long long)y * h / dh);
+        int y1 = std::max(y0 + 1, (int)((long long)(y + 1) * h / dh));
+        for (int x = 0; x < dw; x++) {
+            int x0 = (int)((long long)x * w / dw);
+            int x1 = std::max(x0 + 1, (int)((long long)(x + 1) * w / dw));
+            double sum[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; sy++) {
+                const unsigned char* row = src + ((size_t)sy * w + x0) * channels;
+                for (int sx = x0; sx < x1; sx++, row += channels) {
+                    double weight = channels == 4 ? row[3] : 1.0;
+                    for (int c = 0; c < channels; c++) {
+                        sum[c] += (channels == 4 && c < 3) ? row[c] * weight : row[c];
+                    }
+                }
+            }
+            double count = (double)(y1 - y0) * (x1 - x0);
+            unsigned char* out = dst + ((size_t)y * dw + x) * channels;
+            for (int c = 0; c < channels; c++) {
+                double value;
+                if (channels == 4 && c < 3) value = sum[3] > 0 ? sum[c] / sum[3] : 0;
+                else value = sum[c] / count;
+                out[c] = (unsigned char)std::min(255.0, value + 0.5);
+            }
+        }
+    }
+}
+
 class Texture {
 private:
     unsigned int id;
     int width, height, channels;
     
-public:
-    Texture() : id(0), width(0), height(0), channels(0) {}
-    
-    bool load(const std::string& path) {
-        stbi_set_flip_vertically_on_load(true);
-        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
-        
-        if (!data) {
-            std::cout << "Failed to load texture: " << path << std::endl;
-            return false;
-        }
+    // New texture object with the game's usual sampling, bound to GL_TEXTURE_2D
+    void beginUpload(int w, int h, int c) {
+        release();
+        width = w;
+        height = h;
+        channels = c;
         
         glGenTextures(1, &id);
         glBindTexture(GL_TEXTURE_2D, id);
@@ -30,13 +100,147 @@ public:
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    
+    // Bind and map 'pbo' for 'size' bytes of pixel data. Returns nullptr
+    // (and leaves nothing bound) when there is no PBO or mapping fails.
+    static unsigned char* mapPbo(unsigned int pbo, GLsizeiptr size) {
+        if (pbo == 0) return nullptr;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (!mapped) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return static_cast<unsigned char*>(mapped);
+    }
+    
+    // With a PBO bound, glTexImage2D takes a byte offset in place of a pointer
+    static const void* pboOffset(size_t offset) {
+        return reinterpret_cast<const void*>(offset);
+    }
+    
+public:
+    Texture() : id(0), width(0), height(0), channels(0) {}
+    
+    bool load(const std::string& path, const TextureLimit& limit = TextureLimit()) {
+        DecodedImage image;
+        if (!decode(path, image)) {
+            std::cout << "Failed to load texture: " << path << std::endl;
+            return false;
+        }
+        int w, h;
+        limit.fit(image.width, image.height, w, h);
+        if (w != image.width || h != image.height) {
+            // malloc to match stbi_image_free in freeDecoded()
+            unsigned char* scaled = (unsigned char*)std::malloc((size_t)w * h * image.channels);
+            if (scaled) {
+                downscalePixels(image.pixels, image.width, image.height, image.channels, scaled, w, h);
+                stbi_image_free(image.pixels);
+                image.pixels = scaled;
+                image.width = w;
+                image.height = h;
+            }
+        }
+        upload(image, 0, limit.mipmaps);
+        freeDecoded(image);
+        return true;
+    }
+    
+    // Decode only, no GL calls: safe to run on any thread
+    static bool decode(const std::string& path, DecodedImage& out) {
+        stbi_set_flip_vertically_on_load_thread(1);
+        out.path = path;
+        out.pixels = stbi_load(path.c_str(), &out.width, &out.height, &out.channels, 0);
+        return out.pixels != nullptr;
+    }
+    
+    static void freeDecoded(DecodedImage& image) {
+        stbi_image_free(image.pixels);
+        image.pixels = nullptr;
+    }
+    
+    // Upload decoded pixels (GL thread only). With a pixel unpack buffer the
+    // pixels are copied into a mapped PBO and glTexImage2D reads from there,
+    // so the driver can transfer them without holding up the caller.
+    bool upload(const DecodedImage& image, unsigned int pbo = 0, bool mipmaps = true) {
+        beginUpload(image.width, image.height, image.channels);
         
         GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        GLsizeiptr size = (GLsizeiptr)width * height * channels;
+        const void* source = image.pixels;
+        unsigned char* staged = mapPbo(pbo, size);
+        if (staged) {
+            std::memcpy(staged, image.pixels, size);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            source = pboOffset(0);
+        }
         
-        stbi_image_free(data);
-        std::cout << "Loaded texture: " << path << " (" << width << "x" << height << ")" << std::endl;
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, source);
+        // Leaving the PBO bound would turn later pixel pointers into offsets
+        if (staged) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (mipmaps) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        } else {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        }
+        
+        std::cout << "Loaded texture: " << image.path << " (" << width << "x" << height << ")" << std::endl;
+        return true;
+    }
+    
+    // Upload a prebuilt RGBA8 mip chain (e.g. from TextureCache) as-is,
+    // with no glGenerateMipmap. A single level is sampled without mipmaps.
+    bool upload(const std::string& label, const MipChain& mips, unsigned int pbo = 0) {
+        if (mips.levels == 0) return false;
+        beginUpload(mips.width[0], mips.height[0], 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mips.levels - 1);
+        if (mips.levels > 1) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        
+        size_t offsets[MipChain::MAX_LEVELS];
+        size_t total = 0;
+        for (int i = 0; i < mips.levels; i++) {
+            offsets[i] = total;
+            total += mips.levelSize(i);
+        }
+        unsigned char* staged = mapPbo(pbo, (GLsizeiptr)total);
+        if (staged) {
+            for (int i = 0; i < mips.levels; i++) {
+                std::memcpy(staged + offsets[i], mips.data[i], mips.levelSize(i));
+            }
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        
+        for (int i = 0; i < mips.levels; i++) {
+            const void* source = staged ? pboOffset(offsets[i]) : mips.data[i];
+            glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, mips.width[i], mips.height[i], 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, source);
+        }
+        if (staged) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        
+        std::cout << "Loaded texture: " << label << " (" << width << "x" << height
+                  << ", " << mips.levels << " cached mip" << (mips.levels == 1 ? "" : "s") << ")" << std::endl;
+        return true;
+    }
+    
+    // Create a texture from raw RGBA pixels already in memory (bottom row first).
+    // Pass nullptr to allocate uninitialized storage, e.g. for a render target.
+    bool createFromPixels(int w, int h, const unsigned char* rgba, bool nearest = false) {
+        release();
+        width = w;
+        height = h;
+        channels = 4;
+        
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D, id);
+        
+        GLint filter = nearest ? GL_NEAREST : GL_LINEAR;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
         return true;
     }
     
@@ -44,6 +248,13 @@ public:
         glBindTexture(GL_TEXTURE_2D, id);
     }
     
+    void release() {
+        if (id != 0) {
+            glDeleteTextures(1, &id);
+            id = 0;
+        }
+    }
+    
     unsigned int getID() const { return id; }
     int getWidth() const { return width; }
     int getHeight() const { return height; }
@@ -0,0 +1,183 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+/**
+ * TextureAtlas
+ * ============
+ *
+ * PURPOSE:
+ * Packs many small images into one or a few large textures ("pages") so a
+ * frame that draws all of them needs a single texture binding, and the
+ * sprite batch never has to cut a draw between them.
+ *
+ * USAGE:
+ * 1. add() every image (RGBA8, bottom row first); keep the pixels alive
+ * 2. build() once on the GL thread: packs, uploads pages, returns false if
+ *    nothing fit
+ * 3. region(handle) gives the page and UV rectangle for drawing
+ *
+ * PACKING:
+ * - Shelf packer: images sorted by height, placed left to right in rows,
+ *   opening a new page when a row no longer fits
+ * - Page width is min(MAX_PAGE_SIZE, GL_MAX_TEXTURE_SIZE); page height
+ *   is trimmed to what was used
+ * - Every image gets PADDING texels of its own edge pixels copied around it,
+ *   so linear filtering never samples a neighbour
+ * - An image too large for a page is left out; region() then returns an
+ *   invalid region and the caller keeps its own texture
+ *
+ * USED BY:
+ * - AssetManager (sprites for all loaded images)
+ * - Renderer2D (font glyphs share the first page)
+ *
+ * DEPENDENCIES:
+ * - Texture.h for page textures
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include "Texture.h"
+
+// A rectangle of a texture. v0 is the bottom row, v1 the top row, matching
+// how images are uploaded (bottom row first).
+struct SpriteRegion {
+    const Texture* texture;
+    float u0, v0, u1, v1;
+
+    SpriteRegion() : texture(nullptr), u0(0), v0(0), u1(1), v1(1) {}
+
+    // The whole of a standalone texture
+    static SpriteRegion whole(const Texture* tex) {
+        SpriteRegion region;
+        region.texture = tex;
+        return region;
+    }
+
+    bool isValid() const { return texture != nullptr; }
+};
+
+class TextureAtlas {
+public:
+    static const int MAX_PAGE_SIZE = 2048;
+    static const int PADDING = 2;
+
+private:
+    struct Entry {
+        const unsigned char* pixels;
+        int width, height;
+        int page;              // -1 until packed (or if it didn't fit)
+        int x, y;              // texel position of the image inside its page
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::unique_ptr<Texture>> pages;
+    std::vector<int> pageHeights;
+    int pageWidth;
+    bool built;
+
+    // Copy one image plus its extruded border into a page
+    static void blit(std::vector<unsigned char>& page, int pageW, const Entry& e) {
+        for (int py = -PADDING; py < e.height + PADDING; py++) {
+            int sy = std::min(std::max(py, 0), e.height - 1);
+            for (int px = -PADDING; px < e.width + PADDING; px++) {
+                int sx = std::min(std::max(px, 0), e.width - 1);
+                const unsigned char* src = &e.pixels[(sy * e.width + sx) * 4];
+                unsigned char* dst = &page[((e.y + py) * pageW + (e.x + px)) * 4];
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = src[3];
+            }
+        }
+    }
+
+public:
+    TextureAtlas() : pageWidth(0), built(false) {}
+
+    // Register an image for packing; returns its sprite handle
+    int add(const unsigned char* rgba, int width, int height) {
+        Entry e = {rgba, width, height, -1, 0, 0};
+        entries.push_back(e);
+        return (int)entries.size() - 1;
+    }
+
+    // Pack and upload all added images. Needs a current GL context; the
+    // added pixels may be freed afterwards.
+    bool build() {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        pageWidth = std::min(MAX_PAGE_SIZE, maxSize > 0 ? (int)maxSize : 1024);
+        int pageLimit = pageWidth;
+
+        std::vector<int> order(entries.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            return entries[a].height > entries[b].height;
+        });
+
+        // Shelf packing
+        int page = -1, shelfX = 0, shelfY = 0, shelfH = 0;
+        for (size_t k = 0; k < order.size(); k++) {
+            Entry& e = entries[order[k]];
+            int w = e.width + PADDING * 2;
+            int h = e.height + PADDING * 2;
+            if (w > pageWidth || h > pageLimit) continue;
+
+            if (page >= 0 && shelfX + w > pageWidth) {
+                shelfY += shelfH;
+                shelfX = 0;
+                shelfH = 0;
+            }
+            if (page < 0 || shelfY + h > pageLimit) {
+                page++;
+                pageHeights.push_back(0);
+                shelfX = shelfY = shelfH = 0;
+            }
+            e.page = page;
+            e.x = shelfX + PADDING;
+            e.y = shelfY + PADDING;
+            shelfX += w;
+            shelfH = std::max(shelfH, h);
+            pageHeights[page] = std::max(pageHeights[page], shelfY + h);
+        }
+
+        for (int p = 0; p <= page; p++) {
+            int height = (pageHeights[p] + 3) & ~3;
+            pageHeights[p] = height;
+            std::vector<unsigned char> pixels((size_t)pageWidth * height * 4, 0);
+            for (const Entry& e : entries) {
+                if (e.page == p) blit(pixels, pageWidth, e);
+            }
+            std::unique_ptr<Texture> tex(new Texture());
+            tex->createFromPixels(pageWidth, height, pixels.data());
+            pages.push_back(std::move(tex));
+        }
+
+        for (Entry& e : entries) e.pixels = nullptr;
+        built = !pages.empty();
+        return built;
+    }
+
+    SpriteRegion region(int handle) const {
+        SpriteRegion r;
+        if (handle < 0 || handle >= (int)entries.size()) return r;
+        const Entry& e = entries[handle];
+        if (e.page < 0) return r;
+
+        float pw = (float)pageWidth;
+        float ph = (float)pageHeights[e.page];
+        r.texture = pages[e.page].get();
+        r.u0 = e.x / pw;
+        r.u1 = (e.x + e.width) / pw;
+        r.v0 = e.y / ph;
+        r.v1 = (e.y + e.height) / ph;
+        return r;
+    }
+
+    bool isBuilt() const { return built; }
+    int getPageCount() const { return (int)pages.size(); }
+};
+
+#endif
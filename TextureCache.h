@@ -0,0 +1,316 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+/**
+ * TextureCache
+ * ============
+ *
+ * PURPOSE:
+ * Skips image decoding and GPU mipmap generation on every launch after the
+ * first. Each source image is converted once into an RGBA8 blob under
+ * .texcache/, already scaled down to its TextureLimit and mipmapped only if
+ * the limit asks for it, which later launches memory-map and upload as-is.
+ *
+ * BLOB FORMAT (native endianness, one file per source image):
+ * - TextureBlobHeader: magic "MTEX", version, source size + mtime, level 0
+ *   size, level count, the TextureLimit it was built for and the byte
+ *   offset of each level
+ * - The levels, level 0 first, each width * height * 4 bytes, bottom row
+ *   first (already flipped for OpenGL), 16-byte aligned
+ *
+ * INVALIDATION:
+ * - A blob is used only if its recorded source size and mtime (to the
+ *   nanosecond) match the current file and the version and TextureLimit
+ *   match
+ * - Anything else (missing, stale, truncated) rebuilds it from the source;
+ *   the new blob is written to a temp file and renamed into place
+ * - If the cache cannot be written the rebuilt chain is used from memory
+ *
+ * THREADING:
+ * acquire() does no GL calls and touches only its own files, so the
+ * AssetManager decode workers call it in parallel.
+ *
+ * USED BY:
+ * - AssetManager decode workers
+ *
+ * DEPENDENCIES:
+ * - Texture.h for stb_image and MipChain
+ * - POSIX mmap/stat (Linux build)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Texture.h"
+
+struct TextureBlobHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtimeSec;
+    int64_t sourceMtimeNsec;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levels;
+    uint32_t limitMipmaps;     // TextureLimit the blob was built for
+    uint32_t limitWidth;
+    uint32_t limitHeight;
+    uint64_t levelOffset[MipChain::MAX_LEVELS];
+};
+
+// A mip chain backed by a mapped cache file or, if the cache was not
+// writable, by memory it owns. Move-only.
+class TextureBlob {
+private:
+    void* mapping;
+    size_t mappingSize;
+    std::vector<unsigned char> owned;
+    MipChain mips;
+
+    // Validate 'data' as a blob and point mips at its levels
+    bool parse(const unsigned char* data, size_t size) {
+        if (size < sizeof(TextureBlobHeader)) return false;
+        const TextureBlobHeader* header = reinterpret_cast<const TextureBlobHeader*>(data);
+        if (header->levels == 0 || header->levels > (uint32_t)MipChain::MAX_LEVELS) return false;
+
+        int w = (int)header->width;
+        int h = (int)header->height;
+        mips.levels = (int)header->levels;
+        for (int i = 0; i < mips.levels; i++) {
+            mips.width[i] = w;
+            mips.height[i] = h;
+            if (header->levelOffset[i] + mips.levelSize(i) > size) return false;
+            mips.data[i] = data + header->levelOffset[i];
+            w = w > 1 ? w / 2 : 1;
+            h = h > 1 ? h / 2 : 1;
+        }
+        return true;
+    }
+
+    void reset() {
+        if (mapping) munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+        owned.clear();
+        mips = MipChain();
+    }
+
+public:
+    TextureBlob() : mapping(nullptr), mappingSize(0) {}
+    ~TextureBlob() { reset(); }
+
+    TextureBlob(const TextureBlob&) = delete;
+    TextureBlob& operator=(const TextureBlob&) = delete;
+
+    TextureBlob(TextureBlob&& other) noexcept : mapping(nullptr), mappingSize(0) {
+        *this = std::move(other);
+    }
+
+    TextureBlob& operator=(TextureBlob&& other) noexcept {
+        if (this != &other) {
+            reset();
+            mapping = other.mapping;
+            mappingSize = other.mappingSize;
+            owned.swap(other.owned);
+            mips = other.mips;   // vector storage moved with the swap
+            other.mapping = nullptr;
+            other.mappingSize = 0;
+            other.mips = MipChain();
+        }
+        return *this;
+    }
+
+    // Map an existing blob file (pages are faulted in here, off the GL thread)
+    bool mapFile(const std::string& path) {
+        reset();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return false;
+
+        mapping = data;
+        mappingSize = (size_t)st.st_size;
+        if (!parse(static_cast<const unsigned char*>(data), mappingSize)) {
+            reset();
+            return false;
+        }
+        return true;
+    }
+
+    // Take ownership of an in-memory blob
+    bool adopt(std::vector<unsigned char>& data) {
+        reset();
+        owned.swap(data);
+        if (!parse(owned.data(), owned.size())) {
+            reset();
+            return false;
+        }
+        return true;
+    }
+
+    const TextureBlobHeader* header() const {
+        if (mapping) return static_cast<const TextureBlobHeader*>(mapping);
+        return owned.empty() ? nullptr : reinterpret_cast<const TextureBlobHeader*>(owned.data());
+    }
+
+    const MipChain& getMips() const { return mips; }
+    bool isMapped() const { return mapping != nullptr; }
+};
+
+class TextureCache {
+public:
+    static const uint32_t VERSION = 2;
+
+    static const char* directory() { return ".texcache"; }
+
+    // Blob path for a source image, e.g. imgs/players/p1.PNG -> .texcache/imgs_players_p1.PNG.mtex
+    static std::string blobPath(const std::string& source) {
+        std::string name = source;
+        for (size_t i = 0; i < name.size(); i++) {
+            if (name[i] == '/' || name[i] == '\\') name[i] = '_';
+        }
+        return std::string(directory()) + "/" + name + ".mtex";
+    }
+
+    // Load 'source' into 'out' from the cache, rebuilding the blob first if
+    // it is missing, stale or built for another limit. Returns false only if
+    // the source can't be decoded. 'fromCache' reports whether an existing
+    // blob was used.
+    static bool acquire(const std::string& source, const TextureLimit& limit,
+                        TextureBlob& out, bool& fromCache) {
+        fromCache = false;
+        struct stat st;
+        if (stat(source.c_str(), &st) != 0) return false;
+
+        std::string path = blobPath(source);
+        if (out.mapFile(path) && matchesSource(*out.header(), st, limit)) {
+            fromCache = true;
+            return true;
+        }
+
+        std::vector<unsigned char> blob;
+        if (!build(source, st, limit, blob)) return false;
+        writeBlob(path, blob);
+        return out.adopt(blob);
+    }
+
+private:
+    static bool matchesSource(const TextureBlobHeader& header, const struct stat& st,
+                              const TextureLimit& limit) {
+        return std::memcmp(header.magic, "MTEX", 4) == 0 &&
+               header.version == VERSION &&
+               header.limitMipmaps == (limit.mipmaps ? 1u : 0u) &&
+               header.limitWidth == (uint32_t)limit.maxWidth &&
+               header.limitHeight == (uint32_t)limit.maxHeight &&
+               header.sourceSize == (uint64_t)st.st_size &&
+               header.sourceMtimeSec == (int64_t)st.st_mtim.tv_sec &&
+               header.sourceMtimeNsec == (int64_t)st.st_mtim.tv_nsec;
+    }
+
+    static size_t align16(size_t n) {
+        return (n + 15) & ~(size_t)15;
+    }
+
+    // 2x2 box filter; odd edges reuse the last row/column
+    static void downsample(const unsigned char* src, int w, int h, unsigned char* dst, int dw, int dh) {
+        for (int y = 0; y < dh; y++) {
+            int y0 = y * 2;
+            int y1 = y0 + 1 < h ? y0 + 1 : h - 1;
+            for (int x = 0; x < dw; x++) {
+                int x0 = x * 2;
+                int x1 = x0 + 1 < w ? x0 + 1 : w - 1;
+                for (int c = 0; c < 4; c++) {
+                    int sum = src[(y0 * w + x0) * 4 + c] + src[(y0 * w + x1) * 4 + c] +
+                              src[(y1 * w + x0) * 4 + c] + src[(y1 * w + x1) * 4 + c];
+                    dst[(y * dw + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    // Decode 'source', fit it to 'limit' and lay out header + level 0 (and
+    // the rest of the mip chain if wanted) in 'blob'
+    static bool build(const std::string& source, const struct stat& st, const TextureLimit& limit,
+                      std::vector<unsigned char>& blob) {
+        stbi_set_flip_vertically_on_load_thread(1);
+        int sourceW, sourceH, channels;
+        unsigned char* pixels = stbi_load(source.c_str(), &sourceW, &sourceH, &channels, 4);
+        if (!pixels) return false;
+        int w, h;
+        limit.fit(sourceW, sourceH, w, h);
+
+        TextureBlobHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "MTEX", 4);
+        header.version = VERSION;
+        header.sourceSize = (uint64_t)st.st_size;
+        header.sourceMtimeSec = (int64_t)st.st_mtim.tv_sec;
+        header.sourceMtimeNsec = (int64_t)st.st_mtim.tv_nsec;
+        header.width = (uint32_t)w;
+        header.height = (uint32_t)h;
+        header.limitMipmaps = limit.mipmaps ? 1u : 0u;
+        header.limitWidth = (uint32_t)limit.maxWidth;
+        header.limitHeight = (uint32_t)limit.maxHeight;
+
+        // Level sizes down to 1x1, or just level 0
+        int lw = w, lh = h;
+        size_t offset = align16(sizeof(TextureBlobHeader));
+        int levels = 0;
+        while (levels < MipChain::MAX_LEVELS) {
+            header.levelOffset[levels++] = offset;
+            offset = align16(offset + (size_t)lw * lh * 4);
+            if (!limit.mipmaps || (lw == 1 && lh == 1)) break;
+            lw = lw > 1 ? lw / 2 : 1;
+            lh = lh > 1 ? lh / 2 : 1;
+        }
+        header.levels = (uint32_t)levels;
+
+        blob.assign(offset, 0);
+        std::memcpy(blob.data(), &header, sizeof(header));
+        if (w != sourceW || h != sourceH) {
+            downscalePixels(pixels, sourceW, sourceH, 4, blob.data() + header.levelOffset[0], w, h);
+        } else {
+            std::memcpy(blob.data() + header.levelOffset[0], pixels, (size_t)w * h * 4);
+        }
+        stbi_image_free(pixels);
+
+        lw = w;
+        lh = h;
+        for (int i = 1; i < levels; i++) {
+            int dw = lw > 1 ? lw / 2 : 1;
+            int dh = lh > 1 ? lh / 2 : 1;
+            downsample(blob.data() + header.levelOffset[i - 1], lw, lh,
+                       blob.data() + header.levelOffset[i], dw, dh);
+            lw = dw;
+            lh = dh;
+        }
+        return true;
+    }
+
+    // Best effort: a failed write just means the next launch rebuilds again
+    static void writeBlob(const std::string& path, const std::vector<unsigned char>& blob) {
+        mkdir(directory(), 0755);
+        std::string temp = path + ".tmp";
+        FILE* file = std::fopen(temp.c_str(), "wb");
+        if (!file) return;
+        bool ok = std::fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok || std::rename(temp.c_str(), path.c_str()) != 0) {
+            std::remove(temp.c_str());
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+/**
+ * ThreadPool
+ * ==========
+ *
+ * PURPOSE:
+ * Runs many independent tasks of uneven length on all cores. Each worker
+ * has its own deque: it pushes and pops its own tasks at the back (LIFO,
+ * cache-warm) and, once empty, steals from the front of the others (FIFO,
+ * the oldest and usually largest work). Workers never share a queue lock
+ * in the common case, so throughput grows with the number of cores.
+ *
+ * USAGE:
+ *   ThreadPool pool(threads);          // 0 = one per hardware thread
+ *   for (...) pool.submit([...] { ... });
+ *   pool.wait();                       // every submitted task has finished
+ *
+ * RULES:
+ * - Tasks must not throw
+ * - currentWorker() is the index (0..size()-1) of the worker running the
+ *   calling task, or -1 outside the pool; use it to give each worker its
+ *   own accumulators instead of sharing atomics
+ * - submit() from inside a task goes to that worker's own deque; from
+ *   other threads tasks are dealt round-robin
+ * - Idle workers sleep on a condition variable; there is no spinning
+ *
+ * USED BY:
+ * - batch_sim (one task per chunk of sessions)
+ *
+ * DEPENDENCIES:
+ * - None (standard library threads only)
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    // One per worker, on its own cache lines
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<unsigned> nextQueue;     // round-robin for outside submits
+    std::atomic<long> queued;            // submitted, not yet taken
+    std::atomic<long> pending;           // submitted, not yet finished
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wake;        // workers: queued > 0 or stopping
+    std::condition_variable idle;        // wait(): pending == 0
+
+    struct WorkerContext {
+        const ThreadPool* pool;
+        int index;
+    };
+
+    static WorkerContext& context() {
+        thread_local WorkerContext current = {nullptr, -1};
+        return current;
+    }
+
+    bool popOwn(int index, Task& task) {
+        Queue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(int thief, Task& task) {
+        int count = (int)queues.size();
+        for (int k = 1; k < count; k++) {
+            Queue& queue = *queues[(thief + k) % count];
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || queue.tasks.empty()) continue;
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int index) {
+        context().pool = this;
+        context().index = index;
+        Task task;
+        for (;;) {
+            if (popOwn(index, task) || steal(index, task)) {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                task();
+                task = nullptr;
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    idle.notify_all();
+                }
+                continue;
+            }
+            // queued only rises under sleepMutex, so no submit is missed here.
+            // A steal that lost a lock race finds queued > 0 and retries.
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+            if (stopping.load() && queued.load() <= 0) return;
+        }
+    }
+
+public:
+    explicit ThreadPool(int threadCount = 0)
+        : nextQueue(0), queued(0), pending(0), stopping(false) {
+        if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+        if (threadCount <= 0) threadCount = 1;
+        for (int i = 0; i < threadCount; i++) queues.emplace_back(new Queue());
+        for (int i = 0; i < threadCount; i++) threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    // Finishes every submitted task, then joins the workers
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping.store(true);
+        }
+        wake.notify_all();
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)threads.size(); }
+
+    static int currentWorker() { return context().index; }
+
+    void submit(Task task) {
+        int index = context().pool == this ? context().index
+                                           : (int)(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+        pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            Queue& queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake.notify_one();
+    }
+
+    // Block until every task submitted so far has finished (not from a task)
+    void wait() {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        idle.wait(lock, [this] { return pending.load(std::memory_order_acquire) == 0; });
+    }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+/**
+ * TripleBuffer
+ * ============
+ *
+ * PURPOSE:
+ * Hands the latest value from one producer thread to one consumer thread
+ * without locks and without either side ever waiting. The producer always
+ * has a slot of its own to fill and the consumer always has a complete one
+ * to read; values published in between reads are simply skipped.
+ *
+ * HOW:
+ * Three slots. Besides the producer's back slot and the consumer's front
+ * slot, 'shared' holds the index of the middle slot plus a FRESH bit.
+ * publish() swaps back <-> middle and sets FRESH; update() swaps
+ * front <-> middle only if FRESH is set.
+ *
+ * RULES:
+ * - Only one thread may call writeBuffer()/publish(), only one
+ *   update()/readBuffer()
+ * - readBuffer() stays valid and unchanged until the next update()
+ *
+ * USED BY:
+ * - SimThread (simulation thread -> GL thread world snapshots)
+ *
+ * DEPENDENCIES:
+ * - None (std::atomic only)
+ */
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+private:
+    static const unsigned INDEX_MASK = 3u;
+    static const unsigned FRESH = 4u;
+
+    T slots[3];
+    alignas(64) std::atomic<unsigned> shared;   // middle slot | FRESH
+    alignas(64) unsigned back;                  // producer only
+    alignas(64) unsigned front;                 // consumer only
+
+public:
+    TripleBuffer() : shared(1), back(0), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer: the slot to fill next (holds whatever was there before)
+    T& writeBuffer() { return slots[back]; }
+
+    // Producer: make writeBuffer() the newest value
+    void publish() {
+        back = shared.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Consumer: switch to the newest published value. Returns false if
+    // nothing was published since the last call.
+    bool update() {
+        if (!(shared.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = shared.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer: the value taken by the last update()
+    const T& readBuffer() const { return slots[front]; }
+
+    // Either side, while the other thread is not running
+    void reset(const T& value) {
+        for (int i = 0; i < 3; i++) slots[i] = value;
+        shared.store(1, std::memory_order_relaxed);
+        back = 0;
+        front = 2;
+    }
+};
+
+#endif
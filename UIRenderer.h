@@ -31,6 +31,8 @@
  * - Abilities: SHIELD, DOUBLE JUMP, MAGNET, DASH
  * 
  * PLAYING:
+ * - Retained: each HUD widget caches its quads and is only rebuilt when
+ *   the value it shows changes (mute flag, whole-second timer, coin count)
  * - Top-left: Music status (ON/OFF with M key)
  * - Top-right: Ability status (timer/cooldown/ready)
  * - Upper-left: Coin counter with icon
@@ -43,6 +45,10 @@
  * - Best score
  * - Pulsing "PRESS SPACE TO RESTART" prompt
  * 
+ * DEBUG (profiling builds only):
+ * - Bottom-right: frame time p50/p99 and per-phase CPU/GPU times
+ * - Left of it: last frame's counters (draws, quads, binds, entities, allocations)
+ * 
  * USED BY:
  * - Game class (calls render methods based on game state)
  * 
@@ -54,26 +60,94 @@
 
 #include <string>
 #include <cmath>
+#include <cstdio>
 #include "Renderer2D.h"
+#include "Profiler.h"
 #include "Player.h"
 #include "Texture.h"
 
+// One retained HUD element. Its quads are regenerated only when the key
+// built from its inputs changes; otherwise the cached geometry is replayed.
+struct RetainedWidget {
+    long long key = 0;
+    bool built = false;
+    QuadList quads;
+    
+    bool needsRebuild(long long newKey) {
+        if (built && key == newKey) return false;
+        key = newKey;
+        built = true;
+        return true;
+    }
+    
+    void invalidate() { built = false; }
+};
+
 class UIRenderer {
 private:
     Renderer2D& renderer;
     
+    RetainedWidget musicWidget;
+    RetainedWidget abilityWidget;
+    RetainedWidget coinWidget;
+    RetainedWidget controlsWidget;
+    
+    void buildMusicWidget(bool musicMuted) {
+        renderer.drawQuad(10, 10, 180, 40, nullptr, 0, 0, 0, 0.7);
+        if (musicMuted) {
+            renderer.drawText("MUSIC OFF M", 20, 20, 20, 1, 0, 0);
+        } else {
+            renderer.drawText("MUSIC ON M", 20, 20, 20, 0, 1, 0);
+        }
+    }
+    
+    void buildAbilityWidget(const Player& player) {
+        renderer.drawQuad(SCREEN_WIDTH - 210, 10, 200, 80, nullptr, 0, 0, 0, 0.7);
+        renderer.drawText("Q ABILITY", SCREEN_WIDTH - 190, 20, 25, 1, 1, 0);
+        
+        if (player.abilityActive) {
+            int timeLeft = (int)player.abilityTimer + 1;
+            std::string timerText = "ACTIVE " + std::to_string(timeLeft) + "S";
+            renderer.drawText(timerText.c_str(), SCREEN_WIDTH - 190, 50, 25, 0, 1, 0);
+        } else if (player.abilityCooldown > 0) {
+            int cooldown = (int)player.abilityCooldown + 1;
+            std::string coolText = "COOLDOWN " + std::to_string(cooldown) + "S";
+            renderer.drawText(coolText.c_str(), SCREEN_WIDTH - 200, 50, 20, 1, 0.5, 0);
+        } else {
+            renderer.drawText("READY", SCREEN_WIDTH - 170, 50, 25, 0, 1, 0);
+        }
+    }
+    
+    // What the ability panel shows, packed into one comparable value
+    static long long abilityKey(const Player& player) {
+        if (player.abilityActive) return 1000 + (int)player.abilityTimer;
+        if (player.abilityCooldown > 0) return 2000 + (int)player.abilityCooldown;
+        return 0;
+    }
+    
+    void buildCoinWidget(int coinsCollected) {
+        renderer.drawQuad(20, 20, 250, 70, nullptr, 0, 0, 0, 0.7);
+        renderer.drawQuad(30, 30, 40, 40, nullptr, 1, 0.84, 0);
+        renderer.drawText("COINS " + std::to_string(coinsCollected), 80, 40, 30, 1, 1, 0);
+    }
+    
+    void buildControlsWidget() {
+        renderer.drawQuad(20, 700, 350, 80, nullptr, 0, 0, 0, 0.6);
+        renderer.drawText("UP W SPACE TO JUMP", 30, 720, 25, 1, 1, 1);
+    }
+    
 public:
     UIRenderer(Renderer2D& rend) : renderer(rend) {}
     
-    void renderStartScreen(Texture* bgTexture) {
-        renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, bgTexture);
+    void renderStartScreen(const SpriteRegion& background) {
+        renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, background);
         renderer.drawQuad(SCREEN_WIDTH/2 - 250, 100, 500, 100, nullptr, 0, 0, 0, 0.8);
         renderer.drawText("METRO RUNNER", SCREEN_WIDTH/2 - 200, 120, 50, 1, 1, 0);
         renderer.drawText("PRESS ANY KEY", SCREEN_WIDTH/2 - 200, 250, 40, 0, 1, 0);
     }
     
-    void renderCharacterSelect(Texture* bgTexture, Texture* playerHeads[], int selectedChar) {
-        renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, bgTexture, 1, 1, 1, 0.3);
+    void renderCharacterSelect(const SpriteRegion& background, const SpriteRegion playerHeads[], int selectedChar) {
+        renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, background, 1, 1, 1, 0.3);
         
         for (int i = 0; i < 4; i++) {
             renderCharacter(i, selectedChar, playerHeads);
@@ -85,7 +159,7 @@ public:
         renderer.drawText("LEFT RIGHT ARROWS - SPACE TO START", SCREEN_WIDTH/2 - 350, 675, 30, 1, 1, 1);
     }
     
-    void renderCharacter(int i, int selectedChar, Texture* playerHeads[]) {
+    void renderCharacter(int i, int selectedChar, const SpriteRegion playerHeads[]) {
         float charX = 200 + i * 250;
         float charY = SCREEN_HEIGHT/2 - 50;
         bool selected = (i == selectedChar);
@@ -123,7 +197,7 @@ public:
         renderer.drawText(descriptions[i], charX + descOffsets[i], charY + 195, 18, 0.8, 0.8, 0.8);
     }
     
-    void renderPlayer(const Player& player, Texture* playerHeads[]) {
+    void renderPlayer(const Player& player, const SpriteRegion playerHeads[]) {
         float px = player.x;
         float py = player.y;
         float headSize = 25;
@@ -147,42 +221,54 @@ public:
         renderer.drawQuad(px + player.width/2 + 7, stickY + headSize + bodyLength, 3, legLength, nullptr, 0, 0, 0);
     }
     
+    // Cached quads remember which texture they sample; call after the font
+    // or sprites move (e.g. into an atlas)
+    void invalidateRetained() {
+        musicWidget.invalidate();
+        abilityWidget.invalidate();
+        coinWidget.invalidate();
+        controlsWidget.invalidate();
+    }
+    
     void renderHUD(const Player& player, int coinsCollected, bool musicMuted) {
-        // Music indicator
-        renderer.drawQuad(10, 10, 180, 40, nullptr, 0, 0, 0, 0.7);
-        if (musicMuted) {
-            renderer.drawText("MUSIC OFF M", 20, 20, 20, 1, 0, 0);
-        } else {
-            renderer.drawText("MUSIC ON M", 20, 20, 20, 0, 1, 0);
+        // Widgets are replayed in the same order they used to be drawn,
+        // since the coin panel overlaps the music indicator
+        if (musicWidget.needsRebuild(musicMuted)) {
+            renderer.beginCapture(musicWidget.quads);
+            buildMusicWidget(musicMuted);
+            renderer.endCapture();
         }
+        renderer.drawQuadList(musicWidget.quads);
         
-        // Ability status
-        renderer.drawQuad(SCREEN_WIDTH - 210, 10, 200, 80, nullptr, 0, 0, 0, 0.7);
-        renderer.drawText("Q ABILITY", SCREEN_WIDTH - 190, 20, 25, 1, 1, 0);
-        
-        if (player.abilityActive) {
-            int timeLeft = (int)player.abilityTimer + 1;
-            std::string timerText = "ACTIVE " + std::to_string(timeLeft) + "S";
-            renderer.drawText(timerText.c_str(), SCREEN_WIDTH - 190, 50, 25, 0, 1, 0);
-        } else if (player.abilityCooldown > 0) {
-            int cooldown = (int)player.abilityCooldown + 1;
-            std::string coolText = "COOLDOWN " + std::to_string(cooldown) + "S";
-            renderer.drawText(coolText.c_str(), SCREEN_WIDTH - 200, 50, 20, 1, 0.5, 0);
-        } else {
-            renderer.drawText("READY", SCREEN_WIDTH - 170, 50, 25, 0, 1, 0);
+        if (abilityWidget.needsRebuild(abilityKey(player))) {
+            renderer.beginCapture(abilityWidget.quads);
+            buildAbilityWidget(player);
+            renderer.endCapture();
         }
+        renderer.drawQuadList(abilityWidget.quads);
         
-        // Coin counter
-        renderer.drawQuad(20, 20, 250, 70, nullptr, 0, 0, 0, 0.7);
-        renderer.drawQuad(30, 30, 40, 40, nullptr, 1, 0.84, 0);
-        renderer.drawText("COINS " + std::to_string(coinsCollected), 80, 40, 30, 1, 1, 0);
+        if (coinWidget.needsRebuild(coinsCollected)) {
+            renderer.beginCapture(coinWidget.quads);
+            buildCoinWidget(coinsCollected);
+            renderer.endCapture();
+        }
+        renderer.drawQuadList(coinWidget.quads);
         
-        // Controls
-        renderer.drawQuad(20, 700, 350, 80, nullptr, 0, 0, 0, 0.6);
-        renderer.drawText("UP W SPACE TO JUMP", 30, 720, 25, 1, 1, 1);
+        if (controlsWidget.needsRebuild(0)) {
+            renderer.beginCapture(controlsWidget.quads);
+            buildControlsWidget();
+            renderer.endCapture();
+        }
+        renderer.drawQuadList(controlsWidget.quads);
     }
     
     void renderGameOver(int coinsCollected, int bestScore, float currentTime) {
+        renderGameOverStatic(coinsCollected, bestScore);
+        renderGameOverPrompt(currentTime);
+    }
+    
+    // Everything on the game over screen that doesn't animate
+    void renderGameOverStatic(int coinsCollected, int bestScore) {
         renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, nullptr, 0, 0, 0, 0.7);
         renderer.drawQuad(SCREEN_WIDTH/2 - 300, SCREEN_HEIGHT/2 - 250, 600, 500, nullptr, 0.2, 0.2, 0.3, 0.95);
         
@@ -193,11 +279,61 @@ public:
         
         renderer.drawQuad(SCREEN_WIDTH/2 - 250, SCREEN_HEIGHT/2, 500, 70, nullptr, 0.3, 0.9, 0.3, 0.8);
         renderer.drawText("BEST " + std::to_string(bestScore), SCREEN_WIDTH/2 - 80, SCREEN_HEIGHT/2 + 20, 40, 0, 0, 0);
-        
+    }
+    
+    // Pulsing restart button, the only animated part of the game over screen
+    void renderGameOverPrompt(float currentTime) {
         float pulse = 0.5f + 0.3f * sin(currentTime * 5);
         renderer.drawQuad(SCREEN_WIDTH/2 - 200, SCREEN_HEIGHT/2 + 100, 400, 70, nullptr, 0.2, pulse, 0.2);
         renderer.drawText("PRESS SPACE TO RESTART", SCREEN_WIDTH/2 - 190, SCREEN_HEIGHT/2 + 120, 30, 1, 1, 1);
     }
+    
+#ifdef METRO_PROFILE
+    void renderProfilerOverlay(const FrameProfiler& profiler) {
+        float x = SCREEN_WIDTH - 330;
+        float y = 560;
+        char line[64];
+        
+        renderer.drawQuad(x, y, 320, 170, nullptr, 0, 0, 0, 0.75);
+        
+        std::snprintf(line, sizeof(line), "FRAME %.1f/%.1f MS", profiler.getP50(), profiler.getP99());
+        renderer.drawText(line, x + 10, y + 10, 16, 1, 1, 0);
+        renderer.drawText("P50/P99", x + 10, y + 32, 12, 0.7, 0.7, 0.7);
+        
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            static const char* labels[PHASE_COUNT] = {"INPUT", "UPDATE", "RENDER", "SWAP"};
+            std::snprintf(line, sizeof(line), "%s %.2f", labels[i], profiler.getPhaseMs(i));
+            renderer.drawText(line, x + 10, y + 52 + i * 22, 16, 1, 1, 1);
+        }
+        
+        if (profiler.hasGpuTimes()) {
+            std::snprintf(line, sizeof(line), "GPU %.2f", profiler.getGpuMs());
+            renderer.drawText(line, x + 10, y + 52 + PHASE_COUNT * 22, 16, 0, 1, 1);
+        }
+        
+        // Counters of the last finished frame, which include this overlay
+        x -= 330;
+        renderer.drawQuad(x, y, 320, 170, nullptr, 0, 0, 0, 0.75);
+        std::snprintf(line, sizeof(line), "DRAWS %u", profiler.getCounter(COUNTER_DRAW_CALLS));
+        renderer.drawText(line, x + 10, y + 10, 16, 1, 1, 0);
+        std::snprintf(line, sizeof(line), "QUADS %u GLYPHS %u", profiler.getCounter(COUNTER_QUADS),
+                      profiler.getCounter(COUNTER_GLYPHS));
+        renderer.drawText(line, x + 10, y + 36, 16, 1, 1, 1);
+        std::snprintf(line, sizeof(line), "BINDS TEX %u PROG %u", profiler.getCounter(COUNTER_TEXTURE_BINDS),
+                      profiler.getCounter(COUNTER_PROGRAM_BINDS));
+        renderer.drawText(line, x + 10, y + 58, 16, 1, 1, 1);
+        std::snprintf(line, sizeof(line), "UNIFORMS %u", profiler.getCounter(COUNTER_UNIFORM_UPLOADS));
+        renderer.drawText(line, x + 10, y + 80, 16, 1, 1, 1);
+        std::snprintf(line, sizeof(line), "ENTITIES %u", profiler.getCounter(COUNTER_ENTITIES));
+        renderer.drawText(line, x + 10, y + 102, 16, 1, 1, 1);
+        if (profiler.countsAllocations()) {
+            std::snprintf(line, sizeof(line), "ALLOCS %u", profiler.getCounter(COUNTER_ALLOCATIONS));
+        } else {
+            std::snprintf(line, sizeof(line), "ALLOCS NOT COUNTED");
+        }
+        renderer.drawText(line, x + 10, y + 124, 16, 0, 1, 1);
+    }
+#endif
 };
 
 #endif
@@ -0,0 +1,233 @@
+#ifndef VIRTUAL_SCREEN_H
+#define VIRTUAL_SCREEN_H
+
+/**
+ * VirtualScreen
+ * =============
+ *
+ * PURPOSE:
+ * Keeps the game's fill rate independent of the display. Every frame is
+ * drawn at the fixed virtual resolution (SCREEN_WIDTH x SCREEN_HEIGHT, the
+ * coordinate space Renderer2D already uses) into an off-screen target, then
+ * upscaled to the window in a single textured quad.
+ *
+ * PRESENTATION:
+ * - The target keeps the virtual aspect ratio; the window gets black bars
+ *   where its aspect differs (letterbox / pillarbox)
+ * - Upscaling is bilinear (the target texture samples GL_LINEAR)
+ * - If the framebuffer cannot be created, frames are drawn straight to the
+ *   letterboxed window viewport instead
+ *
+ * DYNAMIC RESOLUTION (GameOptions --dynamic-res):
+ * - The scene is drawn into the lower-left scale x scale part of the
+ *   target, so changing the scale never reallocates anything
+ * - GL_TIMESTAMP queries around the scene pass give its GPU time a few
+ *   frames later, without stalling (they do not conflict with the
+ *   profiler's GL_TIME_ELAPSED query)
+ * - Every ADJUST_FRAMES samples the average is compared with the budget
+ *   (BUDGET_FRACTION of the frame period; the upscale and compositing need
+ *   the rest). Over budget: drop straight to the scale whose predicted
+ *   time (cost ~ pixel count) fits. Comfortably under: one SCALE_STEP up.
+ *
+ * USED BY:
+ * - Game class (render / presentFrame)
+ *
+ * DEPENDENCIES:
+ * - RenderTarget, Renderer2D, GameConfig (virtual size)
+ */
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "GameConfig.h"
+#include "RenderTarget.h"
+#include "Renderer2D.h"
+
+class VirtualScreen {
+public:
+    static constexpr float MIN_SCALE = 0.5f;
+    static constexpr float SCALE_STEP = 0.05f;
+
+private:
+    static const int QUERY_RING = 4;                  // frames of queries in flight
+    static const int ADJUST_FRAMES = 20;
+    static constexpr float BUDGET_FRACTION = 0.75f;
+    static constexpr float TARGET_FRACTION = 0.85f;   // of the budget, after a change
+
+    RenderTarget target;
+    bool dynamic;
+    float scale;
+    float budgetMs;
+
+    // Letterboxed part of the window, updated by present()
+    int viewX, viewY, viewWidth, viewHeight;
+
+    // GPU timing of the scene pass: a begin/end timestamp pair per frame
+    unsigned int queries[QUERY_RING * 2];
+    bool queryPending[QUERY_RING];
+    int queryWrite;
+    int queryRead;
+    bool queryOpen;
+    bool gpuReady;
+
+    double windowMs;          // summed scene times of the current window
+    int windowSamples;
+
+    // For the exit summary
+    int scaleChanges;
+    float lowestScale;
+
+    // Scene pixel size at the current scale
+    int sceneWidth() const { return std::max(1, (int)std::lround(SCREEN_WIDTH * scale)); }
+    int sceneHeight() const { return std::max(1, (int)std::lround(SCREEN_HEIGHT * scale)); }
+
+    static float quantize(float s) {
+        s = std::round(s / SCALE_STEP) * SCALE_STEP;
+        return std::min(1.0f, std::max(MIN_SCALE, s));
+    }
+
+    // Collect finished queries without blocking
+    void pollQueries() {
+        while (queryPending[queryRead]) {
+            int available = 0;
+            glGetQueryObjectiv(queries[queryRead * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint64 start = 0, end = 0;
+            glGetQueryObjectui64v(queries[queryRead * 2], GL_QUERY_RESULT, &start);
+            glGetQueryObjectui64v(queries[queryRead * 2 + 1], GL_QUERY_RESULT, &end);
+            queryPending[queryRead] = false;
+            queryRead = (queryRead + 1) % QUERY_RING;
+            if (end > start) addSample((end - start) / 1.0e6);
+        }
+    }
+
+    void addSample(double ms) {
+        windowMs += ms;
+        if (++windowSamples < ADJUST_FRAMES) return;
+
+        double averageMs = windowMs / windowSamples;
+        windowMs = 0;
+        windowSamples = 0;
+
+        // Scene cost scales with the pixel count, i.e. with scale squared
+        float next = scale;
+        if (averageMs > budgetMs) {
+            float fit = scale * (float)std::sqrt(budgetMs * TARGET_FRACTION / averageMs);
+            next = std::min(quantize(fit), quantize(scale - SCALE_STEP));
+        } else if (scale < 1.0f) {
+            float up = quantize(scale + SCALE_STEP);
+            double predictedMs = averageMs * (up * up) / (scale * scale);
+            if (predictedMs < budgetMs * TARGET_FRACTION) next = up;
+        }
+        if (next != scale) {
+            scale = next;
+            scaleChanges++;
+            lowestScale = std::min(lowestScale, scale);
+        }
+    }
+
+public:
+    VirtualScreen() : dynamic(false), scale(1.0f), budgetMs(0),
+        viewX(0), viewY(0), viewWidth(SCREEN_WIDTH), viewHeight(SCREEN_HEIGHT),
+        queryWrite(0), queryRead(0), queryOpen(false), gpuReady(false),
+        windowMs(0), windowSamples(0), scaleChanges(0), lowestScale(1.0f) {
+        for (int i = 0; i < QUERY_RING; i++) queryPending[i] = false;
+        for (int i = 0; i < QUERY_RING * 2; i++) queries[i] = 0;
+    }
+
+    VirtualScreen(const VirtualScreen&) = delete;
+    VirtualScreen& operator=(const VirtualScreen&) = delete;
+
+    ~VirtualScreen() {
+        if (gpuReady) glDeleteQueries(QUERY_RING * 2, queries);
+    }
+
+    // Needs a current GL context. 'framePeriod' in seconds (FramePacer).
+    void init(bool dynamicResolution, double framePeriod) {
+        if (!target.create(SCREEN_WIDTH, SCREEN_HEIGHT)) {
+            std::cerr << "Warning: no virtual screen framebuffer, drawing at window resolution" << std::endl;
+        }
+        dynamic = dynamicResolution && target.isValid();
+        budgetMs = (float)(framePeriod * 1000.0 * BUDGET_FRACTION);
+        if (dynamic) {
+            glGenQueries(QUERY_RING * 2, queries);
+            gpuReady = true;
+        }
+        std::cout << "Virtual resolution: " << SCREEN_WIDTH << "x" << SCREEN_HEIGHT;
+        if (dynamic) std::cout << " (dynamic, " << budgetMs << " ms scene budget)";
+        std::cout << std::endl;
+    }
+
+    // Start drawing a frame in virtual coordinates
+    void begin(int windowWidth, int windowHeight) {
+        updateViewport(windowWidth, windowHeight);
+        if (!target.isValid()) {
+            glViewport(viewX, viewY, viewWidth, viewHeight);
+            return;
+        }
+        target.begin();
+        glViewport(0, 0, sceneWidth(), sceneHeight());
+
+        // All queries still in flight: skip timing this frame rather than stall
+        if (gpuReady && !queryPending[queryWrite]) {
+            glQueryCounter(queries[queryWrite * 2], GL_TIMESTAMP);
+            queryOpen = true;
+        }
+    }
+
+    // Finish the frame: upscale the scene into the letterboxed window area
+    void present(Renderer2D& renderer, int windowWidth, int windowHeight) {
+        if (!target.isValid()) {
+            glViewport(0, 0, windowWidth, windowHeight);
+            return;
+        }
+        if (queryOpen) {
+            glQueryCounter(queries[queryWrite * 2 + 1], GL_TIMESTAMP);
+            queryPending[queryWrite] = true;
+            queryWrite = (queryWrite + 1) % QUERY_RING;
+            queryOpen = false;
+        }
+
+        SpriteRegion scene = SpriteRegion::whole(target.getTexture());
+        scene.u1 = (float)sceneWidth() / SCREEN_WIDTH;
+        scene.v1 = (float)sceneHeight() / SCREEN_HEIGHT;
+
+        target.end(windowWidth, windowHeight);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glViewport(viewX, viewY, viewWidth, viewHeight);
+        renderer.beginBatch();
+        renderer.drawQuad(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, scene);
+        renderer.endBatch();
+        glViewport(0, 0, windowWidth, windowHeight);
+
+        // Results of earlier frames; this one's arrive a few frames later
+        if (gpuReady) pollQueries();
+    }
+
+    // Largest virtual-aspect rectangle centred in the window
+    void updateViewport(int windowWidth, int windowHeight) {
+        if ((long long)windowWidth * SCREEN_HEIGHT > (long long)windowHeight * SCREEN_WIDTH) {
+            viewHeight = windowHeight;
+            viewWidth = (int)((long long)windowHeight * SCREEN_WIDTH / SCREEN_HEIGHT);
+        } else {
+            viewWidth = windowWidth;
+            viewHeight = (int)((long long)windowWidth * SCREEN_HEIGHT / SCREEN_WIDTH);
+        }
+        viewX = (windowWidth - viewWidth) / 2;
+        viewY = (windowHeight - viewHeight) / 2;
+    }
+
+    void printSummary() const {
+        if (!dynamic) return;
+        std::cout << "Dynamic resolution: " << scaleChanges << " scale changes, lowest "
+                  << lowestScale << ", final " << scale << std::endl;
+    }
+
+    float getScale() const { return scale; }
+    bool isDynamic() const { return dynamic; }
+};
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef WORLD_BUFFER_H
+#define WORLD_BUFFER_H
+
+/**
+ * WorldBuffer
+ * ===========
+ *
+ * PURPOSE:
+ * GPU-resident copy of the world's metros, obstacles and coins (GameOptions
+ * --gpu-world). Everything in the world scrolls left by the same step each
+ * tick, so quads are stored once in world space and a single scroll uniform
+ * moves them all. Per-frame uploads depend on what spawned, not on how many
+ * entities are on screen.
+ *
+ * LAYOUT:
+ * - One static vertex buffer of quads (BatchVertex layout, x in world
+ *   pixels relative to 'base', y in screen pixels)
+ * - Slots mirror the simulation's storage: metros [0, MAX_METROS), then
+ *   every ObstacleRing slot, then every CoinRing slot. A ring entity keeps
+ *   its slot from push to popFront, so a despawn needs no write at all:
+ *   draws only cover the rings' live spans.
+ *
+ * SYNC (once per frame, after the ticks):
+ * - New ring entities (EntityRing::pushes since the last sync) are written
+ *   at their world x = screen x + GameWorld::getScrollDistance()
+ * - A recycled metro is found by its world x jumping; it is rewritten
+ * - A collected coin's quad is collapsed to zero area
+ * - Full rewrite on a new world (GameWorld::getGeneration), a new metro
+ *   sprite (atlas built), or when the scroll passes REBASE_DISTANCE: world
+ *   x is kept relative to 'base' so the float uniform stays precise
+ *
+ * DRAW:
+ * One glMultiDrawElements call over at most 5 ranges (metros, two spans
+ * per ring), in the CPU path's painter's order: metros, obstacles, coins.
+ *
+ * USED BY:
+ * - Game class (renderPlaying, when --gpu-world is on)
+ *
+ * DEPENDENCIES:
+ * - Renderer2D.h (compileProgram, BatchVertex), GameWorld.h
+ */
+
+#include <glad/glad.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "GameConfig.h"
+#include "GameWorld.h"
+#include "Renderer2D.h"
+
+class WorldBuffer {
+public:
+    static const int MAX_METROS = 16;
+    static const int OBSTACLE_BASE = MAX_METROS;
+    static const int COIN_BASE = OBSTACLE_BASE + ObstacleRing::CAPACITY;
+    static const int SLOT_COUNT = COIN_BASE + CoinRing::CAPACITY;
+    static constexpr double REBASE_DISTANCE = 65536.0;   // keeps float world x within 1/128 px
+
+private:
+    unsigned int vao, vbo, ebo;
+    unsigned int program;
+    int scrollLocation;
+
+    // What the buffer currently holds
+    bool synced;
+    uint32_t generation;
+    double base;                         // world distance that x = 0 stands for
+    uint32_t obstaclePushes, coinPushes;
+    float metroX[MAX_METROS];            // world x relative to base
+    int metroCount;
+    bool coinHidden[CoinRing::CAPACITY];
+    SpriteRegion metroSprite;
+
+    // Upload statistics
+    uint64_t uploadedBytes;
+    uint64_t frames;
+    unsigned fullRewrites;
+
+    const char* vertexShaderSource = R"(
+        #version 330 core
+        layout (location = 0) in vec2 aPos;
+        layout (location = 1) in vec2 aTexCoord;
+        layout (location = 2) in vec4 aColor;
+        layout (location = 3) in float aTexMix;
+        uniform float uScroll;
+        uniform vec2 uScreen;
+        out vec2 TexCoord;
+        out vec4 Color;
+        out float TexMix;
+        void main() {
+            vec2 pixel = vec2(aPos.x - uScroll, aPos.y);
+            gl_Position = vec4(pixel.x * 2.0 / uScreen.x - 1.0, 1.0 - pixel.y * 2.0 / uScreen.y, 0.0, 1.0);
+            TexCoord = aTexCoord;
+            Color = aColor;
+            TexMix = aTexMix;
+        }
+    )";
+
+    const char* fragmentShaderSource = R"(
+        #version 330 core
+        in vec2 TexCoord;
+        in vec4 Color;
+        in float TexMix;
+        out vec4 FragColor;
+        uniform sampler2D texture1;
+        void main() {
+            vec4 t = texture(texture1, TexCoord);
+            FragColor = mix(Color, t * Color, TexMix);
+        }
+    )";
+
+    static bool sameSprite(const SpriteRegion& a, const SpriteRegion& b) {
+        return a.texture == b.texture && a.u0 == b.u0 && a.v0 == b.v0 && a.u1 == b.u1 && a.v1 == b.v1;
+    }
+
+    // Same corner order and V flip as Renderer2D::submitQuad
+    void writeQuad(int slot, float x, float y, float w, float h, const SpriteRegion* sprite,
+                   float r, float g, float b) {
+        float u0 = 0, vTop = 1, u1 = 1, vBottom = 0, mix = 0;
+        if (sprite && sprite->isValid()) {
+            u0 = sprite->u0;
+            u1 = sprite->u1;
+            vTop = sprite->v1;
+            vBottom = sprite->v0;
+            mix = 1;
+        }
+        BatchVertex quad[4] = {
+            {x, y, u0, vTop, r, g, b, 1, mix},
+            {x + w, y, u1, vTop, r, g, b, 1, mix},
+            {x + w, y + h, u1, vBottom, r, g, b, 1, mix},
+            {x, y + h, u0, vBottom, r, g, b, 1, mix}
+        };
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)slot * sizeof(quad), sizeof(quad), quad);
+        uploadedBytes += sizeof(quad);
+    }
+
+    // Zero-area quad: drawn, but covers no pixels
+    void hideQuad(int slot) {
+        writeQuad(slot, 0, 0, 0, 0, nullptr, 0, 0, 0);
+    }
+
+    void writeObstacle(const ObstacleRing& obstacles, int i, double scroll) {
+        bool flying = obstacles.flags[i] & ENTITY_FLYING;
+        writeQuad(OBSTACLE_BASE + i, (float)(obstacles.x[i] + scroll - base), obstacles.y[i],
+                  obstacles.w[i], obstacles.h[i], nullptr, flying ? 1.0f : 0.8f, flying ? 0.5f : 0.2f, 0.2f);
+    }
+
+    void writeCoin(const CoinRing& coins, int i, double scroll) {
+        coinHidden[i] = (coins.flags[i] & ENTITY_COLLECTED) != 0;
+        if (coinHidden[i]) hideQuad(COIN_BASE + i);
+        else writeQuad(COIN_BASE + i, (float)(coins.x[i] + scroll - base), coins.y[i],
+                       coins.w[i], coins.h[i], nullptr, 1, 0.84f, 0);
+    }
+
+    void writeMetro(const Metro& metro, int i, double scroll) {
+        metroX[i] = (float)(metro.x + scroll - base);
+        writeQuad(i, metroX[i], metro.y, metro.width, 100, &metroSprite, 1, 1, 1);
+    }
+
+    void rewriteAll(const GameWorld& world) {
+        double scroll = world.getScrollDistance();
+        const std::vector<Metro>& metros = world.getMetros();
+        metroCount = std::min((int)metros.size(), MAX_METROS);
+        for (int i = 0; i < metroCount; i++) writeMetro(metros[i], i, scroll);
+
+        const ObstacleRing& obstacles = world.getObstacles();
+        for (int n = 0; n < obstacles.size(); n++) writeObstacle(obstacles, obstacles.slot(n), scroll);
+        const CoinRing& coins = world.getCoins();
+        for (int n = 0; n < coins.size(); n++) writeCoin(coins, coins.slot(n), scroll);
+
+        obstaclePushes = obstacles.pushes;
+        coinPushes = coins.pushes;
+        generation = world.getGeneration();
+        synced = true;
+        fullRewrites++;
+    }
+
+    template <typename Ring>
+    static int addSpans(const Ring& ring, int slotBase, GLsizei counts[], const void* offsets[], int n) {
+        int begin[2], end[2];
+        int spans = ring.spans(begin, end);
+        for (int s = 0; s < spans; s++) {
+            counts[n] = (GLsizei)((end[s] - begin[s]) * 6);
+            offsets[n] = (const void*)((size_t)(slotBase + begin[s]) * 6 * sizeof(unsigned int));
+            n++;
+        }
+        return n;
+    }
+
+public:
+    WorldBuffer() : vao(0), vbo(0), ebo(0), program(0), scrollLocation(-1),
+        synced(false), generation(0), base(0), obstaclePushes(0), coinPushes(0), metroCount(0),
+        uploadedBytes(0), frames(0), fullRewrites(0) {
+        for (int i = 0; i < MAX_METROS; i++) metroX[i] = 0;
+        for (int i = 0; i < CoinRing::CAPACITY; i++) coinHidden[i] = false;
+    }
+
+    WorldBuffer(const WorldBuffer&) = delete;
+    WorldBuffer& operator=(const WorldBuffer&) = delete;
+
+    ~WorldBuffer() {
+        if (vao != 0) {
+            glDeleteVertexArrays(1, &vao);
+            glDeleteBuffers(1, &vbo);
+            glDeleteBuffers(1, &ebo);
+            glDeleteProgram(program);
+        }
+    }
+
+    // Needs a current GL context
+    void init() {
+        program = compileProgram(vertexShaderSource, fragmentShaderSource);
+
+        std::vector<unsigned int> indices(SLOT_COUNT * 6);
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            unsigned int first = i * 4;
+            indices[i*6 + 0] = first + 0;
+            indices[i*6 + 1] = first + 1;
+            indices[i*6 + 2] = first + 2;
+            indices[i*6 + 3] = first + 2;
+            indices[i*6 + 4] = first + 3;
+            indices[i*6 + 5] = first + 0;
+        }
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        // Written a few quads at a time, drawn every frame
+        glBufferData(GL_ARRAY_BUFFER, SLOT_COUNT * 4 * sizeof(BatchVertex), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+        GLsizei stride = sizeof(BatchVertex);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, x));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, u));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, r));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(BatchVertex, texMix));
+        glEnableVertexAttribArray(3);
+        glBindVertexArray(0);
+
+        scrollLocation = glGetUniformLocation(program, "uScroll");
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "texture1"), 0);
+        glUniform2f(glGetUniformLocation(program, "uScreen"), (float)SCREEN_WIDTH, (float)SCREEN_HEIGHT);
+        glUseProgram(0);
+        std::cout << "GPU world buffer: " << SLOT_COUNT << " quad slots" << std::endl;
+    }
+
+    bool isReady() const { return vao != 0; }
+
+    // One draw through this pipeline before the first visible frame, so the
+    // driver finishes setting it up during loading. Draws a zero-area quad.
+    void warmUp() {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        hideQuad(0);
+        synced = false;   // slot 0 is a metro; rewrite everything on the first sync
+        glUseProgram(program);
+        glUniform1f(scrollLocation, 0.0f);
+        glBindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)0);
+        glBindVertexArray(0);
+    }
+
+    // Bring the buffer up to date with the world after this frame's ticks
+    void sync(const GameWorld& world, const SpriteRegion& sprite) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        frames++;
+        double scroll = world.getScrollDistance();
+
+        bool rebase = scroll - base > REBASE_DISTANCE || scroll < base;
+        if (rebase) base = scroll;
+        if (!synced || rebase || world.getGeneration() != generation || !sameSprite(sprite, metroSprite)) {
+            metroSprite = sprite;
+            rewriteAll(world);
+            return;
+        }
+
+        // Recycled metros jump right by a whole track length
+        const std::vector<Metro>& metros = world.getMetros();
+        for (int i = 0; i < metroCount; i++) {
+            float x = (float)(metros[i].x + scroll - base);
+            if (std::fabs(x - metroX[i]) > 1.0f) writeMetro(metros[i], i, scroll);
+        }
+
+        // New entities are the last (pushes - seen) live ones
+        const ObstacleRing& obstacles = world.getObstacles();
+        int fresh = std::min((int)(obstacles.pushes - obstaclePushes), obstacles.size());
+        for (int n = obstacles.size() - fresh; n < obstacles.size(); n++) {
+            writeObstacle(obstacles, obstacles.slot(n), scroll);
+        }
+        obstaclePushes = obstacles.pushes;
+
+        const CoinRing& coins = world.getCoins();
+        fresh = std::min((int)(coins.pushes - coinPushes), coins.size());
+        int firstFresh = coins.size() - fresh;
+        for (int n = 0; n < coins.size(); n++) {
+            int i = coins.slot(n);
+            if (n >= firstFresh) writeCoin(coins, i, scroll);
+            else if ((coins.flags[i] & ENTITY_COLLECTED) && !coinHidden[i]) writeCoin(coins, i, scroll);
+        }
+        coinPushes = coins.pushes;
+    }
+
+    // Draw the synced world; 'scrollLag' as in Game::renderPlaying. Binds
+    // its own program and VAO, so invalidate Renderer2D's state afterwards.
+    // The GL calls are added to 'stats' (usually Renderer2D's).
+    void draw(const GameWorld& world, float scrollLag, RenderStats& stats) {
+        GLsizei counts[5];
+        const void* offsets[5];
+        int ranges = 0;
+        if (metroCount > 0) {
+            counts[ranges] = metroCount * 6;
+            offsets[ranges] = (const void*)0;
+            ranges++;
+        }
+        ranges = addSpans(world.getObstacles(), OBSTACLE_BASE, counts, offsets, ranges);
+        ranges = addSpans(world.getCoins(), COIN_BASE, counts, offsets, ranges);
+        if (ranges == 0) return;
+
+        glUseProgram(program);
+        glUniform1f(scrollLocation, (float)(world.getScrollDistance() - base) - scrollLag);
+        glBindVertexArray(vao);
+        glActiveTexture(GL_TEXTURE0);
+        if (metroSprite.isValid()) glBindTexture(GL_TEXTURE_2D, metroSprite.texture->getID());
+        glMultiDrawElements(GL_TRIANGLES, counts, GL_UNSIGNED_INT, offsets, ranges);
+        glBindVertexArray(0);
+
+        stats.drawCalls++;
+        stats.programBinds++;
+        stats.uniformUploads++;
+        if (metroSprite.isValid()) stats.textureBinds++;
+        for (int i = 0; i < ranges; i++) stats.quads += counts[i] / 6;
+    }
+
+    void printSummary() const {
+        if (frames == 0) return;
+        std::cout << "GPU world buffer: " << (double)uploadedBytes / frames << " bytes/frame uploaded over "
+                  << frames << " frames (" << fullRewrites << " full rewrites)" << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,347 @@
+/**
+ * batch_sim - difficulty tuning across all cores
+ * ==============================================
+ *
+ * Runs many independent headless sessions (Simulation + BotPolicy) on a
+ * work-stealing ThreadPool and aggregates how they end per speed tier and
+ * per character: how many sessions reach a tier, how many die there and
+ * of what (obstacle, fall, or still alive at --max-minutes), survival time
+ * and coins. A GameTuning with --tune overrides sets the speed ramp, spawn
+ * intervals and ability timings for every session.
+ *
+ * DETERMINISM:
+ * Session k uses world seed Random::deriveSeed(seed, k), its own bot seed
+ * and character k % 4 (or --character). Every aggregate is an integer sum
+ * merged after the run, so the report is identical for any --threads.
+ *
+ * SCALING:
+ * Sessions are grouped into tasks of --chunk sessions; workers share
+ * nothing but the pool's queues and write into their own cache-aligned
+ * aggregates, so throughput grows with the core count until memory
+ * bandwidth matters (one session is a few KB).
+ *
+ * USAGE:
+ *   ./batch_sim [--sessions N] [--threads T] [--seed S] [--character 0-3|-1]
+ *               [--policy random|scripted|lookahead] [--max-minutes M]
+ *               [--chunk C] [--tune key=value]... [--out file.json]
+ *
+ *   --sessions     sessions to run (default 10000)
+ *   --threads      worker threads, 0 = one per hardware thread (default 0)
+ *   --seed         base seed (default 1)
+ *   --character    fixed character, or -1 to cycle through all four (default -1)
+ *   --policy       bot input policy (default lookahead)
+ *   --max-minutes  a session still alive after this long ends as a timeout (default 30)
+ *   --chunk        sessions per pool task (default 16)
+ *   --tune         override a GameTuning value, e.g. --tune speed_step=0.75;
+ *                  keys: see GameTuning::keyNames(); spawn rates the track
+ *                  cannot hold are refused (GameWorld::tuningProblem)
+ *   --out          also write the aggregates as JSON (BenchReport format)
+ *
+ * BUILD:
+ *   g++ -O2 -pthread -o batch_sim batch_sim.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "BotPolicy.h"
+#include "GameTuning.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "BenchReport.h"
+
+// Tier t is gameSpeed = startSpeed + t * speedStep; the last one also
+// holds everything faster
+static const int MAX_TIERS = 64;
+static const int CHARACTERS = GameTuning::CHARACTERS;
+// Bot seeds come from their own stream of the base seed
+static const uint64_t BOT_STREAM = 0xB07B07B07B07B07BULL;
+
+enum EndKind { END_OBSTACLE, END_FALL, END_TIMEOUT, END_KINDS };
+
+static const char* endKindName(int kind) {
+    static const char* names[END_KINDS] = {"obstacle", "fall", "timeout"};
+    return names[kind];
+}
+
+// Sums over sessions that ended in one tier or played one character
+struct EndCounts {
+    uint64_t sessions;
+    uint64_t ends[END_KINDS];
+    uint64_t ticks;
+    uint64_t coins;
+};
+
+// One worker's share of the results; merged after the pool is done
+struct alignas(64) Aggregate {
+    uint64_t reached[MAX_TIERS];     // sessions that played at this tier at all
+    EndCounts tiers[MAX_TIERS];      // sessions that ended at this tier
+    EndCounts characters[CHARACTERS];
+    uint64_t ticks;
+
+    Aggregate() : reached(), tiers(), characters(), ticks(0) {}
+
+    static void add(EndCounts& into, const EndCounts& from) {
+        into.sessions += from.sessions;
+        for (int k = 0; k < END_KINDS; k++) into.ends[k] += from.ends[k];
+        into.ticks += from.ticks;
+        into.coins += from.coins;
+    }
+
+    void merge(const Aggregate& other) {
+        for (int t = 0; t < MAX_TIERS; t++) {
+            reached[t] += other.reached[t];
+            add(tiers[t], other.tiers[t]);
+        }
+        for (int c = 0; c < CHARACTERS; c++) add(characters[c], other.characters[c]);
+        ticks += other.ticks;
+    }
+};
+
+struct BatchConfig {
+    uint64_t seed;
+    int character;
+    BotKind policy;
+    long long maxTicks;
+    GameTuning tuning;
+};
+
+static int speedTier(const GameTuning& tuning, float speed) {
+    if (tuning.speedStep <= 0) return 0;
+    int tier = (int)((speed - tuning.startSpeed) / tuning.speedStep + 0.5f);
+    return std::max(0, std::min(tier, MAX_TIERS - 1));
+}
+
+static void record(EndCounts& counts, EndKind end, long long ticks, int coins) {
+    counts.sessions++;
+    counts.ends[end]++;
+    counts.ticks += ticks;
+    counts.coins += coins;
+}
+
+// Sessions [first, last); survival[k] gets session k's ticks
+static void runSessions(const BatchConfig& config, long long first, long long last,
+                        Aggregate& aggregate, std::vector<uint32_t>& survival) {
+    Simulation sim(config.tuning);
+    for (long long k = first; k < last; k++) {
+        int character = config.character >= 0 ? config.character : (int)(k % CHARACTERS);
+        sim.reset(character, Random::deriveSeed(config.seed, (uint64_t)k));
+        BotPolicy bot(config.policy, (uint32_t)Random::deriveSeed(config.seed ^ BOT_STREAM, (uint64_t)k));
+
+        while (sim.getTicks() < config.maxTicks && sim.tick(bot.decide(sim), SIM_DT)) {
+        }
+
+        EndKind end = END_TIMEOUT;
+        if (sim.getRunEnd() == RunEnd::OBSTACLE) end = END_OBSTACLE;
+        else if (sim.getRunEnd() == RunEnd::FALL) end = END_FALL;
+
+        const GameWorld& world = sim.getWorld();
+        int tier = speedTier(config.tuning, world.getGameSpeed());
+        for (int t = 0; t <= tier; t++) aggregate.reached[t]++;
+        record(aggregate.tiers[tier], end, sim.getTicks(), world.getCoinsCollected());
+        record(aggregate.characters[character], end, sim.getTicks(), world.getCoinsCollected());
+        aggregate.ticks += sim.getTicks();
+        survival[k] = (uint32_t)sim.getTicks();
+    }
+}
+
+static double seconds(uint64_t ticks) { return ticks * (double)SIM_DT; }
+
+static double mean(uint64_t sum, uint64_t count) { return count ? (double)sum / count : 0; }
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--sessions N] [--threads T] [--seed S] [--character 0-3|-1]"
+              << " [--policy random|scripted|lookahead] [--max-minutes M] [--chunk C]"
+              << " [--tune key=value]... [--out file.json]" << std::endl;
+    std::cerr << "Tuning keys: " << GameTuning::keyNames() << std::endl;
+}
+
+int main(int argc, char** argv) {
+    long long sessions = 10000;
+    int threads = 0;
+    int chunk = 16;
+    double maxMinutes = 30;
+    std::string outFile;
+    BatchConfig config;
+    config.seed = 1;
+    config.character = -1;
+    config.policy = BotKind::LOOKAHEAD;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--sessions" && hasValue) {
+            sessions = std::atoll(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--character" && hasValue) {
+            config.character = std::atoi(argv[++i]);
+        } else if (arg == "--policy" && hasValue) {
+            if (!parseBotKind(argv[++i], config.policy)) {
+                std::cerr << "Unknown policy: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--max-minutes" && hasValue) {
+            maxMinutes = std::atof(argv[++i]);
+        } else if (arg == "--chunk" && hasValue) {
+            chunk = std::atoi(argv[++i]);
+        } else if (arg == "--tune" && hasValue) {
+            std::string setting = argv[++i];
+            size_t eq = setting.find('=');
+            if (eq == std::string::npos ||
+                !config.tuning.set(setting.substr(0, eq), (float)std::atof(setting.c_str() + eq + 1))) {
+                std::cerr << "Bad tuning: " << setting << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--out" && hasValue) {
+            outFile = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (sessions <= 0) sessions = 1;
+    if (chunk <= 0) chunk = 1;
+    if (config.character >= CHARACTERS) config.character = -1;
+    config.maxTicks = (long long)(maxMinutes * 60.0 / SIM_DT);
+    if (config.maxTicks <= 0) config.maxTicks = 1;
+    std::string tuningProblem = GameWorld::tuningProblem(config.tuning);
+    if (!tuningProblem.empty()) {
+        std::cerr << "Bad tuning: " << tuningProblem << std::endl;
+        return 1;
+    }
+
+    gameLogEnabled() = false;
+
+    std::vector<uint32_t> survival(sessions);
+    std::vector<Aggregate> perWorker;
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        threads = pool.size();
+        perWorker.resize(threads);
+        for (long long first = 0; first < sessions; first += chunk) {
+            long long last = std::min(sessions, first + chunk);
+            pool.submit([&config, &perWorker, &survival, first, last] {
+                runSessions(config, first, last, perWorker[ThreadPool::currentWorker()], survival);
+            });
+        }
+        pool.wait();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Aggregate total;
+    for (const Aggregate& aggregate : perWorker) total.merge(aggregate);
+    std::sort(survival.begin(), survival.end());
+    EndCounts all = {};
+    for (int c = 0; c < CHARACTERS; c++) Aggregate::add(all, total.characters[c]);
+    double p50 = seconds(survival[(survival.size() - 1) * 50 / 100]);
+    double p90 = seconds(survival[(survival.size() - 1) * 90 / 100]);
+
+    std::cout << "Sessions:     " << sessions << " on " << threads << " threads" << std::endl;
+    std::cout << "Time:         " << elapsed << " s" << std::endl;
+    std::cout << "Ticks/sec:    " << (elapsed > 0 ? total.ticks / elapsed : 0) << std::endl;
+    std::cout << "Sessions/sec: " << (elapsed > 0 ? sessions / elapsed : 0) << std::endl;
+    std::cout << "Survival:     avg " << seconds(total.ticks) / sessions << " s, p50 " << p50
+              << " s, p90 " << p90 << " s" << std::endl;
+    std::cout << "Coins:        avg " << mean(all.coins, all.sessions) << std::endl;
+    std::cout << "Ends:         " << all.ends[END_OBSTACLE] << " obstacle, " << all.ends[END_FALL]
+              << " fall, " << all.ends[END_TIMEOUT] << " timeout" << std::endl;
+
+    std::cout << std::endl << " tier  speed  reached  ended  obstacle   fall  timeout  avg_s   avg_coins" << std::endl;
+    char line[160];
+    for (int t = 0; t < MAX_TIERS; t++) {
+        if (total.reached[t] == 0) continue;
+        const EndCounts& tier = total.tiers[t];
+        std::snprintf(line, sizeof(line), "%5d %6.2f %8llu %6llu %9llu %6llu %8llu %6.1f %11.1f", t,
+                      config.tuning.startSpeed + t * config.tuning.speedStep,
+                      (unsigned long long)total.reached[t], (unsigned long long)tier.sessions,
+                      (unsigned long long)tier.ends[END_OBSTACLE], (unsigned long long)tier.ends[END_FALL],
+                      (unsigned long long)tier.ends[END_TIMEOUT], seconds(tier.ticks) / std::max<uint64_t>(tier.sessions, 1),
+                      mean(tier.coins, tier.sessions));
+        std::cout << line << std::endl;
+    }
+
+    std::cout << std::endl << " character  sessions  avg_s   avg_coins  obstacle   fall  timeout" << std::endl;
+    for (int c = 0; c < CHARACTERS; c++) {
+        const EndCounts& character = total.characters[c];
+        if (character.sessions == 0) continue;
+        std::snprintf(line, sizeof(line), "%10d %9llu %6.1f %11.1f %9llu %6llu %8llu", c,
+                      (unsigned long long)character.sessions, seconds(character.ticks) / character.sessions,
+                      mean(character.coins, character.sessions), (unsigned long long)character.ends[END_OBSTACLE],
+                      (unsigned long long)character.ends[END_FALL], (unsigned long long)character.ends[END_TIMEOUT]);
+        std::cout << line << std::endl;
+    }
+
+    if (outFile.empty()) return 0;
+
+    const GameTuning& tuning = config.tuning;
+    BenchReport report("batch_sim");
+    BenchReport::Result& summary = report.add("all")
+        .param("sessions", (double)sessions)
+        .param("threads", threads)
+        .param("seed", (double)config.seed)
+        .param("max_minutes", maxMinutes)
+        .param("start_speed", tuning.startSpeed)
+        .param("speed_step", tuning.speedStep)
+        .param("speed_interval", tuning.speedInterval)
+        .param("obstacle_interval", tuning.obstacleInterval)
+        .param("coin_interval", tuning.coinInterval)
+        .param("metro_gap_min", tuning.metroGapMin)
+        .param("metro_gap_max", tuning.metroGapMax)
+        .param("ability_cooldown", tuning.abilityCooldown);
+    for (int c = 0; c < CHARACTERS; c++) {
+        summary.param("ability_duration_" + std::to_string(c), tuning.abilityDuration[c]);
+    }
+    summary.metric("sessions_per_sec", elapsed > 0 ? sessions / elapsed : 0)
+        .metric("ticks_per_sec", elapsed > 0 ? total.ticks / elapsed : 0)
+        .metric("survival_s_avg", seconds(total.ticks) / sessions)
+        .metric("survival_s_p50", p50)
+        .metric("survival_s_p90", p90)
+        .metric("coins_avg", mean(all.coins, all.sessions));
+    for (int k = 0; k < END_KINDS; k++) {
+        summary.metric(std::string("ends_") + endKindName(k), (double)all.ends[k]);
+    }
+
+    for (int t = 0; t < MAX_TIERS; t++) {
+        if (total.reached[t] == 0) continue;
+        const EndCounts& tier = total.tiers[t];
+        BenchReport::Result& result = report.add("tier_" + std::to_string(t))
+            .param("tier", t)
+            .param("speed", tuning.startSpeed + t * tuning.speedStep)
+            .metric("reached", (double)total.reached[t])
+            .metric("ended", (double)tier.sessions)
+            .metric("survival_s_avg", tier.sessions ? seconds(tier.ticks) / tier.sessions : 0)
+            .metric("coins_avg", mean(tier.coins, tier.sessions));
+        for (int k = 0; k < END_KINDS; k++) {
+            result.metric(std::string("ends_") + endKindName(k), (double)tier.ends[k]);
+        }
+    }
+    for (int c = 0; c < CHARACTERS; c++) {
+        const EndCounts& character = total.characters[c];
+        if (character.sessions == 0) continue;
+        BenchReport::Result& result = report.add("character_" + std::to_string(c))
+            .param("character", c)
+            .metric("sessions", (double)character.sessions)
+            .metric("survival_s_avg", seconds(character.ticks) / character.sessions)
+            .metric("coins_avg", mean(character.coins, character.sessions));
+        for (int k = 0; k < END_KINDS; k++) {
+            result.metric(std::string("ends_") + endKindName(k), (double)character.ends[k]);
+        }
+    }
+
+    if (!report.save(outFile)) {
+        std::cerr << "Cannot write " << outFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * bench_io - ScoreManager load / save latency
+ * ===========================================
+ *
+ * Measures, for run histories of several sizes:
+ * - load: constructing a ScoreManager (JSON parse + RunHistory footer read)
+ * - save: recordRun() followed by flush(), i.e. until the run record and
+ *   the JSON are on disk (temp file + rename)
+ * - record: recordRun() alone, the cost the game loop actually pays
+ * and reports p50 / p99 / max in microseconds as JSON (see BenchReport.h).
+ * Files live in a fresh directory under /tmp that is removed afterwards.
+ *
+ * USAGE:
+ *   ./bench_io [--iterations N] [--out file.json]
+ *
+ *   --iterations  loads and saves timed per history size (default 200)
+ *   --out         write the JSON report to a file instead of stdout
+ *
+ * BUILD:
+ *   g++ -O2 -pthread -o bench_io bench_io.cpp
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "GameData.h"
+#include "BenchReport.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Latency {
+    double p50, p99, max;
+};
+
+static double microsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+static Latency summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    Latency latency = {0, 0, 0};
+    if (samples.empty()) return latency;
+    latency.p50 = samples[(samples.size() - 1) * 50 / 100];
+    latency.p99 = samples[(samples.size() - 1) * 99 / 100];
+    latency.max = samples.back();
+    return latency;
+}
+
+// gamedata.json, its temp file and gamedata.runs
+static void removeFiles(const std::string& dir) {
+    std::remove((dir + "/gamedata.json").c_str());
+    std::remove((dir + "/gamedata.json.tmp").c_str());
+    std::remove((dir + "/gamedata.runs").c_str());
+}
+
+int main(int argc, char** argv) {
+    int iterations = 200;
+    std::string outFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--iterations" && hasValue) {
+            iterations = std::atoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            outFile = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--iterations N] [--out file.json]" << std::endl;
+            return 1;
+        }
+    }
+    if (iterations <= 0) iterations = 1;
+
+    gameLogEnabled() = false;
+
+    char dirTemplate[] = "/tmp/metro_bench_io_XXXXXX";
+    if (!mkdtemp(dirTemplate)) {
+        std::cerr << "Cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    std::string dir = dirTemplate;
+    std::string json = dir + "/gamedata.json";
+
+    const int historySizes[] = {0, 1000, 100000};
+    BenchReport report("bench_io");
+
+    for (int historySize : historySizes) {
+        removeFiles(dir);
+        {
+            // Build the history in one go; the save thread coalesces it
+            ScoreManager seed(json);
+            for (int r = 0; r < historySize; r++) {
+                seed.recordRun(makeRunRecord(r % 97, 600 + r % 1000, r % 4, 3.0f));
+            }
+        }
+
+        std::vector<double> loads, saves, records;
+        uint32_t runsAfter = 0;
+        for (int i = 0; i < iterations; i++) {
+            Clock::time_point start = Clock::now();
+            ScoreManager scores(json);
+            loads.push_back(microsSince(start));
+
+            start = Clock::now();
+            scores.recordRun(makeRunRecord(i % 50, 900, i % 4, 4.5f));
+            records.push_back(microsSince(start));
+            scores.flush();
+            saves.push_back(microsSince(start));
+            runsAfter = scores.getRunCount();
+        }
+
+        Latency load = summarize(loads);
+        Latency save = summarize(saves);
+        Latency record = summarize(records);
+        std::cerr << "history " << historySize << ": load p50 " << load.p50 << " us, save p50 "
+                  << save.p50 << " us, recordRun p50 " << record.p50 << " us" << std::endl;
+
+        report.add("history_" + std::to_string(historySize))
+            .param("history_runs", historySize)
+            .param("iterations", iterations)
+            .metric("load_us_p50", load.p50)
+            .metric("load_us_p99", load.p99)
+            .metric("load_us_max", load.max)
+            .metric("save_us_p50", save.p50)
+            .metric("save_us_p99", save.p99)
+            .metric("save_us_max", save.max)
+            .metric("record_us_p50", record.p50)
+            .metric("record_us_p99", record.p99)
+            .metric("runs_after", runsAfter);
+    }
+
+    removeFiles(dir);
+    rmdir(dir.c_str());
+
+    if (!report.save(outFile)) {
+        std::cerr << "Cannot write " << outFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
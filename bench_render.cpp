@@ -0,0 +1,229 @@
+/**
+ * bench_render - Renderer2D throughput
+ * ====================================
+ *
+ * Draws into an off-screen RenderTarget from a hidden GLFW window and
+ * reports quads per second and text glyphs per second as JSON (see
+ * BenchReport.h). Every frame ends with glFinish, so the numbers include
+ * the GPU work, not just the CPU side of the batch. Draw calls and texture
+ * binds per frame come from Renderer2D::getStats().
+ *
+ * CASES:
+ *   flat            untextured quads in one batch
+ *   textured        quads sampling one 64x64 texture in one batch
+ *   flat_unbatched  drawQuad outside a batch, one draw call per quad
+ *   text            drawText, one glyph quad per character from the font atlas
+ *
+ * USAGE:
+ *   ./bench_render [--frames N] [--quads Q] [--out file.json]
+ *
+ *   --frames  timed frames per case (default 300)
+ *   --quads   quads per frame for the batched cases (default 10000)
+ *   --out     write the JSON report to a file instead of stdout
+ *
+ * BUILD:
+ *   g++ -O2 -o bench_render bench_render.cpp libs/glad/src/glad.c \
+ *       -Ilibs/glad/include -lglfw -lGL -ldl -pthread
+ */
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Renderer2D.h"
+#include "RenderTarget.h"
+#include "BenchReport.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Frames drawn before timing so buffers and driver state are settled
+static const int WARMUP_FRAMES = 20;
+// drawQuad outside a batch is a draw call each; fewer keep the case short
+static const int UNBATCHED_QUADS = 1000;
+static const float QUAD_SIZE = 16.0f;
+
+enum BenchCase { CASE_FLAT, CASE_TEXTURED, CASE_FLAT_UNBATCHED, CASE_TEXT };
+
+struct CaseInfo {
+    const char* name;
+    BenchCase kind;
+};
+
+// A grid that wraps around the virtual screen, so overdraw stays even
+static void quadPosition(int i, float& x, float& y) {
+    const int columns = (int)(SCREEN_WIDTH / QUAD_SIZE);
+    const int rows = (int)(SCREEN_HEIGHT / QUAD_SIZE);
+    x = (i % columns) * QUAD_SIZE;
+    y = ((i / columns) % rows) * QUAD_SIZE;
+}
+
+static void drawFrame(Renderer2D& renderer, BenchCase kind, int quads, Texture* texture,
+                      const std::string& line, int lines) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    float x, y;
+    switch (kind) {
+    case CASE_FLAT:
+        renderer.beginBatch();
+        for (int i = 0; i < quads; i++) {
+            quadPosition(i, x, y);
+            renderer.drawQuad(x, y, QUAD_SIZE, QUAD_SIZE, nullptr, (i & 7) / 7.0f, 0.5f, 1.0f, 1.0f);
+        }
+        renderer.endBatch();
+        break;
+    case CASE_TEXTURED:
+        renderer.beginBatch();
+        for (int i = 0; i < quads; i++) {
+            quadPosition(i, x, y);
+            renderer.drawQuad(x, y, QUAD_SIZE, QUAD_SIZE, texture);
+        }
+        renderer.endBatch();
+        break;
+    case CASE_FLAT_UNBATCHED:
+        for (int i = 0; i < quads; i++) {
+            quadPosition(i, x, y);
+            renderer.drawQuad(x, y, QUAD_SIZE, QUAD_SIZE, nullptr, 1.0f, (i & 7) / 7.0f, 0.5f, 1.0f);
+        }
+        break;
+    case CASE_TEXT:
+        renderer.beginBatch();
+        for (int i = 0; i < lines; i++) {
+            renderer.drawText(line, 0.0f, (float)((i * 20) % SCREEN_HEIGHT), 14.0f);
+        }
+        renderer.endBatch();
+        break;
+    }
+    glFinish();
+}
+
+int main(int argc, char** argv) {
+    int frames = 300;
+    int quads = 10000;
+    std::string outFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--frames" && hasValue) {
+            frames = std::atoi(argv[++i]);
+        } else if (arg == "--quads" && hasValue) {
+            quads = std::atoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            outFile = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames N] [--quads Q] [--out file.json]" << std::endl;
+            return 1;
+        }
+    }
+    if (frames <= 0) frames = 1;
+    if (quads <= 0) quads = 1;
+
+    if (!glfwInit()) {
+        std::cerr << "Failed to init GLFW" << std::endl;
+        return 1;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "bench_render", NULL, NULL);
+    if (!window) {
+        std::cerr << "Failed to create window" << std::endl;
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to init GLAD" << std::endl;
+        return 1;
+    }
+
+    BenchReport report("bench_render");
+    {
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        RenderTarget target;
+        if (!target.create(SCREEN_WIDTH, SCREEN_HEIGHT)) return 1;
+        target.begin();
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+        Renderer2D renderer;
+
+        std::vector<unsigned char> checker(64 * 64 * 4);
+        for (int i = 0; i < 64 * 64; i++) {
+            unsigned char value = (((i % 64) / 8 + (i / 64) / 8) & 1) ? 255 : 64;
+            checker[i * 4 + 0] = value;
+            checker[i * 4 + 1] = value;
+            checker[i * 4 + 2] = value;
+            checker[i * 4 + 3] = 255;
+        }
+        Texture texture;
+        texture.createFromPixels(64, 64, checker.data());
+
+        // 80 printable glyphs per line; lines chosen so the text case
+        // submits about as many quads as the batched cases
+        std::string line;
+        for (int i = 0; i < 80; i++) line += (char)('A' + i % 26);
+        int lines = quads / (int)line.size();
+        if (lines < 1) lines = 1;
+
+        const CaseInfo cases[] = {
+            {"flat", CASE_FLAT},
+            {"textured", CASE_TEXTURED},
+            {"flat_unbatched", CASE_FLAT_UNBATCHED},
+            {"text", CASE_TEXT}
+        };
+
+        for (const CaseInfo& info : cases) {
+            int perFrame = info.kind == CASE_FLAT_UNBATCHED ? std::min(quads, UNBATCHED_QUADS) : quads;
+            if (info.kind == CASE_TEXT) perFrame = lines * (int)line.size();
+
+            for (int f = 0; f < WARMUP_FRAMES; f++) {
+                drawFrame(renderer, info.kind, perFrame, &texture, line, lines);
+            }
+
+            std::vector<double> frameMs;
+            frameMs.reserve(frames);
+            renderer.resetStats();
+            Clock::time_point start = Clock::now();
+            for (int f = 0; f < frames; f++) {
+                Clock::time_point frameStart = Clock::now();
+                drawFrame(renderer, info.kind, perFrame, &texture, line, lines);
+                frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            std::sort(frameMs.begin(), frameMs.end());
+            RenderStats stats = renderer.getStats();
+
+            double perSec = seconds > 0 ? (double)perFrame * frames / seconds : 0;
+            const char* unit = info.kind == CASE_TEXT ? "glyphs_per_sec" : "quads_per_sec";
+            std::cerr << info.name << ": " << perSec << " " << unit << ", "
+                      << frameMs[frameMs.size() / 2] << " ms/frame" << std::endl;
+
+            report.add(info.name)
+                .param(info.kind == CASE_TEXT ? "glyphs_per_frame" : "quads_per_frame", perFrame)
+                .param("frames", frames)
+                .metric(unit, perSec)
+                .metric("frame_ms_p50", frameMs[frameMs.size() / 2])
+                .metric("frame_ms_max", frameMs.back())
+                .metric("draw_calls_per_frame", (double)stats.drawCalls / frames)
+                .metric("texture_binds_per_frame", (double)stats.textureBinds / frames);
+        }
+
+        if (glGetError() != GL_NO_ERROR) std::cerr << "Warning: GL error during the run" << std::endl;
+        target.end(64, 64);
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    if (!report.save(outFile)) {
+        std::cerr << "Cannot write " << outFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
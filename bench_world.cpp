@@ -0,0 +1,140 @@
+/**
+ * bench_world - GameWorld::update throughput
+ * ==========================================
+ *
+ * Steps a GameWorld directly (no Simulation, no game over) at several
+ * entity densities and speed tiers and reports ticks per second as JSON
+ * (see BenchReport.h). The player stands on the first metro; coins it
+ * touches are collected as usual. Links no GLFW, GLAD or SFML.
+ *
+ * DENSITIES: spawn intervals in the GameTuning passed to GameWorld
+ *   default  2.0 s obstacles / 1.5 s coins (the game)
+ *   dense    0.5 s / 0.25 s
+ *   packed   0.15 s / 0.125 s (near TrackSegment's per-segment limits)
+ * SPEEDS: 3 (start), 8 (after ~100 s), 15 (far beyond normal play)
+ *
+ * USAGE:
+ *   ./bench_world [--ticks N] [--repeat R] [--seed S] [--out file.json]
+ *
+ *   --ticks   ticks per measurement (default 500000)
+ *   --repeat  measurements per case, the fastest is reported (default 3)
+ *   --seed    world seed (default 1)
+ *   --out     write the JSON report to a file instead of stdout
+ *
+ * BUILD:
+ *   g++ -O2 -pthread -o bench_world bench_world.cpp
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "GameWorld.h"
+#include "Player.h"
+#include "BenchReport.h"
+
+struct Density {
+    const char* name;
+    float obstacleInterval;
+    float coinInterval;
+};
+
+// Tick long enough for the screen to fill up before measuring
+static const int WARMUP_TICKS = 1200;
+// setGameSpeed holds for 10 s; re-apply it well before that
+static const int SPEED_HOLD_TICKS = 500;
+
+int main(int argc, char** argv) {
+    long long ticks = 500000;
+    int repeat = 3;
+    uint64_t seed = 1;
+    std::string outFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ticks" && hasValue) {
+            ticks = std::atoll(argv[++i]);
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--out" && hasValue) {
+            outFile = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--ticks N] [--repeat R] [--seed S] [--out file.json]" << std::endl;
+            return 1;
+        }
+    }
+    if (ticks <= 0) ticks = 1;
+    if (repeat <= 0) repeat = 1;
+
+    gameLogEnabled() = false;
+
+    const Density densities[] = {
+        {"default", GameTuning().obstacleInterval, GameTuning().coinInterval},
+        {"dense", 0.5f, 0.25f},
+        {"packed", 0.15f, 0.125f}
+    };
+    const float speeds[] = {3.0f, 8.0f, 15.0f};
+
+    BenchReport report("bench_world");
+    for (const Density& density : densities) {
+        for (float speed : speeds) {
+            double bestSeconds = 1e30;
+            double liveSum = 0;
+            long long liveSamples = 0;
+            int coins = 0;
+
+            for (int r = 0; r < repeat; r++) {
+                GameTuning tuning;
+                tuning.obstacleInterval = density.obstacleInterval;
+                tuning.coinInterval = density.coinInterval;
+                GameWorld world(tuning);
+                Player player;
+                world.init(seed);
+                player.y = world.getGroundY(player);
+
+                for (int t = 0; t < WARMUP_TICKS; t++) {
+                    if (t % SPEED_HOLD_TICKS == 0) world.setGameSpeed(speed);
+                    world.update(SIM_DT, player);
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                for (long long t = 0; t < ticks; t++) {
+                    if (t % SPEED_HOLD_TICKS == 0) {
+                        world.setGameSpeed(speed);
+                        liveSum += world.getObstacles().size() + world.getCoins().size();
+                        liveSamples++;
+                    }
+                    world.update(SIM_DT, player);
+                }
+                auto end = std::chrono::steady_clock::now();
+                double seconds = std::chrono::duration<double>(end - start).count();
+                if (seconds < bestSeconds) bestSeconds = seconds;
+                coins = world.getCoinsCollected();
+            }
+
+            double ticksPerSec = bestSeconds > 0 ? ticks / bestSeconds : 0;
+            double live = liveSamples ? liveSum / liveSamples : 0;
+            std::cerr << density.name << " speed " << speed << ": " << ticksPerSec << " ticks/s, "
+                      << live << " live entities" << std::endl;
+
+            report.add(std::string(density.name) + "_speed" + std::to_string((int)speed))
+                .param("obstacle_interval_s", density.obstacleInterval)
+                .param("coin_interval_s", density.coinInterval)
+                .param("speed", speed)
+                .param("ticks", (double)ticks)
+                .metric("ticks_per_sec", ticksPerSec)
+                .metric("ns_per_tick", ticksPerSec > 0 ? 1e9 / ticksPerSec : 0)
+                .metric("live_entities_avg", live)
+                .metric("coins_collected", coins);
+        }
+    }
+
+    if (!report.save(outFile)) {
+        std::cerr << "Cannot write " << outFile << std::endl;
+        return 1;
+    }
+    return 0;
+}
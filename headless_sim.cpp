@@ -0,0 +1,195 @@
+/**
+ * headless_sim - Metro Runner simulation without a display
+ * ========================================================
+ * 
+ * Drives Simulation (GameWorld + Player) with bot input as fast as the CPU
+ * allows and reports ticks per second plus per-run results. Links no GLFW,
+ * GLAD or SFML, so it runs on CI machines without a GPU.
+ * 
+ * USAGE:
+ *   ./headless_sim [--ticks N] [--seed S] [--character 0-3|-1]
+ *                  [--policy random|scripted|lookahead] [--data file.json]
+ *                  [--record file.replay]
+ *   ./headless_sim --replay file.replay [--repeat N]
+ * 
+ *   --ticks      total simulation ticks to run across all sessions (default 1000000)
+ *   --seed       base seed; session k's world uses Random::deriveSeed(seed, k),
+ *                the bot draws from its own stream (default 1)
+ *   --character  fixed character, or -1 to cycle through all four (default -1)
+ *   --policy     bot input policy (default lookahead)
+ *   --data       ScoreManager file; every session is appended to its run
+ *                history (default: none, nothing is written)
+ *   --record     write the first session as an InputRecording
+ *   --replay     re-run a recording (from the game or --record) as fast as
+ *                possible, N times (default 1); exits with status 2 if any
+ *                run does not end exactly as recorded
+ * 
+ * BUILD:
+ *   g++ -O2 -pthread -o headless_sim headless_sim.cpp
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "BotPolicy.h"
+#include "GameData.h"
+#include "InputRecording.h"
+#include "Random.h"
+
+// Re-run a recording 'repeat' times; returns the process exit status
+static int runReplay(const std::string& path, int repeat, float dt) {
+    InputRecording recording;
+    if (!recording.load(path)) {
+        std::cerr << "Cannot read replay: " << path << std::endl;
+        return 1;
+    }
+    
+    Simulation sim;
+    long long ticksRun = 0;
+    int mismatches = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        sim.reset(recording.getCharacter(), recording.getSeed());
+        uint64_t tick = 0;
+        while (tick < recording.getTickCount() && sim.tick(recording.input(tick), dt)) {
+            tick++;
+        }
+        ticksRun += sim.getTicks();
+        if (!recording.matches(sim)) mismatches++;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    
+    std::cout << "Replay:       " << path << " (character " << recording.getCharacter()
+              << ", seed " << recording.getSeed() << ")" << std::endl;
+    std::cout << "Recorded:     " << recording.getTickCount() << " ticks, "
+              << recording.getFinalCoins() << " coins" << std::endl;
+    std::cout << "Replayed:     " << sim.getTicks() << " ticks, "
+              << sim.getWorld().getCoinsCollected() << " coins" << std::endl;
+    std::cout << "Runs:         " << repeat << std::endl;
+    std::cout << "Time:         " << seconds << " s" << std::endl;
+    std::cout << "Ticks/sec:    " << (seconds > 0 ? ticksRun / seconds : 0) << std::endl;
+    if (mismatches > 0) {
+        std::cout << "DIVERGED:     " << mismatches << " of " << repeat << " runs" << std::endl;
+        return 2;
+    }
+    std::cout << "Match:        yes" << std::endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    long long totalTicks = 1000000;
+    unsigned int seed = 1;
+    int character = -1;
+    BotKind policy = BotKind::LOOKAHEAD;
+    std::string dataFile;
+    std::string recordFile;
+    std::string replayFile;
+    int repeat = 1;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ticks" && hasValue) {
+            totalTicks = std::atoll(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--character" && hasValue) {
+            character = std::atoi(argv[++i]);
+        } else if (arg == "--policy" && hasValue) {
+            if (!parseBotKind(argv[++i], policy)) {
+                std::cerr << "Unknown policy: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--data" && hasValue) {
+            dataFile = argv[++i];
+        } else if (arg == "--record" && hasValue) {
+            recordFile = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            replayFile = argv[++i];
+        } else if (arg == "--repeat" && hasValue) {
+            repeat = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--ticks N] [--seed S] [--character 0-3|-1]"
+                      << " [--policy random|scripted|lookahead] [--data file.json]"
+                      << " [--record file] | --replay file [--repeat N]" << std::endl;
+            return 1;
+        }
+    }
+    
+    gameLogEnabled() = false;
+    
+    if (!replayFile.empty()) {
+        return runReplay(replayFile, repeat > 0 ? repeat : 1, SIM_DT);
+    }
+    
+    Simulation sim;
+    InputRecording recording;
+    BotPolicy bot(policy, seed);
+    
+    long long ticksRun = 0;
+    int sessions = 0;
+    int bestCoins = 0;
+    long long totalCoins = 0;
+    long long longestRun = 0;
+    std::vector<RunRecord> runs;
+    
+    auto start = std::chrono::steady_clock::now();
+    while (ticksRun < totalTicks) {
+        int chosen = character >= 0 ? character : sessions % 4;
+        uint64_t sessionSeed = Random::deriveSeed(seed, (uint64_t)sessions);
+        sim.reset(chosen, sessionSeed);
+        
+        bool recordThis = sessions == 0 && !recordFile.empty();
+        if (recordThis) recording.begin(sessionSeed, chosen);
+        
+        for (;;) {
+            if (ticksRun >= totalTicks) break;
+            TickInput input = bot.decide(sim);
+            if (recordThis) recording.record(input);
+            if (!sim.tick(input, SIM_DT)) break;
+            ticksRun++;
+        }
+        if (sim.isGameOver()) ticksRun++;
+        
+        if (recordThis) {
+            recording.finish(sim.getWorld().getCoinsCollected(), sim.isGameOver());
+            if (recording.save(recordFile)) {
+                std::cout << "Recorded session 0 to " << recordFile << std::endl;
+            } else {
+                std::cerr << "Warning: failed to write " << recordFile << std::endl;
+            }
+        }
+        
+        int coins = sim.getWorld().getCoinsCollected();
+        if (coins > bestCoins) bestCoins = coins;
+        if (sim.getTicks() > longestRun) longestRun = sim.getTicks();
+        totalCoins += coins;
+        sessions++;
+        if (!dataFile.empty()) {
+            runs.push_back(makeRunRecord(coins, sim.getTicks(), chosen, sim.getWorld().getGameSpeed()));
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    
+    std::cout << "Ticks:        " << ticksRun << std::endl;
+    std::cout << "Sessions:     " << sessions << std::endl;
+    std::cout << "Time:         " << seconds << " s" << std::endl;
+    std::cout << "Ticks/sec:    " << (seconds > 0 ? ticksRun / seconds : 0) << std::endl;
+    std::cout << "Avg run:      " << (sessions ? ticksRun / 60.0 / sessions : 0) << " s" << std::endl;
+    std::cout << "Longest run:  " << longestRun / 60.0 << " s" << std::endl;
+    std::cout << "Best coins:   " << bestCoins << std::endl;
+    
+    if (!dataFile.empty()) {
+        ScoreManager scores(dataFile);
+        for (size_t i = 0; i < runs.size(); i++) scores.recordRun(runs[i]);
+    }
+    
+    return 0;
+}
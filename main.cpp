@@ -1,7 +1,12 @@
 #include "Game.h"
 
-int main() {
-    Game game;
+int main(int argc, char** argv) {
+    GameOptions options;
+    if (!GameOptions::parse(argc, argv, options)) {
+        return 1;
+    }
+    
+    Game game(options);
     
     if (!game.init()) {
         return -1;